@@ -0,0 +1,272 @@
+// kernel/GUI/core/compositor.c - Damage-basierter Compositor
+// Fenster werden im RAM-Back-Buffer zusammengesetzt, in den (WC-)LFB gehen
+// nur die beschädigten Rechtecke - zeilenweise, ohne ihn je zu lesen.
+// Der Mauszeiger lebt nur im LFB: die Pixel darunter liegen im Save-Under.
+#include "gui.h"
+#include "../../drivers/fbcon.h"
+#include "../../drivers/screen.h"
+#include "../../memory/heap.h"
+#include "../../lib/mem.h"
+#include "../../lib/printf.h"
+
+static int active = 0;
+static struct framebuffer fb;
+static uint32_t* back = 0;              // fb.width * fb.height
+
+static gui_rect_t damage[GUI_MAX_DAMAGE];
+static int damage_count = 0;
+
+// Mauszeiger: 'X' = Rand, '.' = Füllung, ' ' = durchsichtig
+static const char* cursor_shape[GUI_CURSOR_H] = {
+    "X           ",
+    "XX          ",
+    "X.X         ",
+    "X..X        ",
+    "X...X       ",
+    "X....X      ",
+    "X.....X     ",
+    "X......X    ",
+    "X.......X   ",
+    "X........X  ",
+    "X.........X ",
+    "X......XXXXX",
+    "X...X..X    ",
+    "X..XX..X    ",
+    "X.X  X..X   ",
+    "XX   X..X   ",
+    "X     X..X  ",
+    "      X..X  ",
+    "       XX   ",
+};
+
+static int pointer_x = 0;
+static int pointer_y = 0;
+static int pointer_visible = 0;
+static uint32_t save_under[GUI_CURSOR_W * GUI_CURSOR_H];
+
+// Statistik
+static uint32_t flush_count = 0;
+static uint32_t rects_flushed = 0;
+static uint32_t rects_merged = 0;
+static uint32_t pixels_flushed = 0;
+
+static inline void fill32(uint32_t* dest, uint32_t value, uint32_t n) {
+    uint32_t d0, d1;
+    asm volatile("rep stosl"
+                 : "=&c"(d0), "=&D"(d1)
+                 : "0"(n), "1"(dest), "a"(value)
+                 : "memory");
+}
+
+static inline uint32_t* fb_row(int x, int y) {
+    return (uint32_t*)(fb.base + y * fb.pitch) + x;
+}
+
+static inline gui_rect_t screen_rect(void) {
+    return gui_rect(0, 0, fb.width, fb.height);
+}
+
+// ========================
+// INIT
+// ========================
+
+int gui_init(void) {
+    if(active) return 1;
+    if(!fbcon_framebuffer(&fb)) return 0;
+
+    back = (uint32_t*)kmalloc_safe(fb.width * fb.height * 4);
+    if(!back) return 0;
+
+    fbcon_suspend();
+    active = 1;
+    damage_count = 0;
+    pointer_visible = 0;
+    gui_damage(screen_rect());
+    return 1;
+}
+
+void gui_shutdown(void) {
+    if(!active) return;
+    active = 0;
+    kfree_safe(back);
+    back = 0;
+    fbcon_resume();
+}
+
+int gui_active(void) {
+    return active;
+}
+
+int gui_width(void) {
+    return fb.width;
+}
+
+int gui_height(void) {
+    return fb.height;
+}
+
+// ========================
+// DAMAGE
+// ========================
+
+// Zusammenlegen lohnt, wenn sie sich überlappen oder die Hülle nichts
+// Unbeschädigtes dazunimmt (z.B. zwei bündig aneinanderliegende Streifen)
+static int worth_merging(gui_rect_t a, gui_rect_t b) {
+    if(!gui_rect_empty(gui_rect_intersect(a, b))) return 1;
+    gui_rect_t u = gui_rect_union(a, b);
+    return u.w * u.h <= a.w * a.h + b.w * b.h;
+}
+
+void gui_damage(gui_rect_t r) {
+    if(!active) return;
+    r = gui_rect_intersect(r, screen_rect());
+    if(gui_rect_empty(r)) return;
+
+    // Solange verschmelzen, bis r mit keinem Eintrag mehr zusammenpasst
+    int merged = 1;
+    while(merged) {
+        merged = 0;
+        for(int i = 0; i < damage_count; i++) {
+            if(!worth_merging(r, damage[i])) continue;
+            r = gui_rect_union(r, damage[i]);
+            damage[i] = damage[--damage_count];
+            rects_merged++;
+            merged = 1;
+            break;
+        }
+    }
+
+    if(damage_count < GUI_MAX_DAMAGE) {
+        damage[damage_count++] = r;
+        return;
+    }
+
+    // Liste voll: mit dem Eintrag vereinen, dessen Hülle am wenigsten wächst
+    int best = 0;
+    int best_cost = 0x7FFFFFFF;
+    for(int i = 0; i < damage_count; i++) {
+        gui_rect_t u = gui_rect_union(r, damage[i]);
+        int cost = u.w * u.h - damage[i].w * damage[i].h;
+        if(cost < best_cost) {
+            best_cost = cost;
+            best = i;
+        }
+    }
+    damage[best] = gui_rect_union(damage[best], r);
+    rects_merged++;
+}
+
+// ========================
+// KOMPONIEREN
+// ========================
+
+// Hintergrund, dann alle Fenster von unten nach oben - nur innerhalb von r
+static void compose(gui_rect_t r) {
+    for(int y = r.y; y < r.y + r.h; y++) {
+        fill32(back + y * fb.width + r.x, GUI_DESKTOP_COLOR, r.w);
+    }
+
+    for(gui_window_t* win = gui_window_bottom(); win; win = win->next) {
+        gui_rect_t part = gui_rect_intersect(r, win->frame);
+        if(gui_rect_empty(part)) continue;
+
+        for(int y = part.y; y < part.y + part.h; y++) {
+            const uint32_t* src = win->pixels + (y - win->frame.y) * win->frame.w +
+                                  (part.x - win->frame.x);
+            memcpy(back + y * fb.width + part.x, src, part.w * 4);
+        }
+    }
+}
+
+static void present(gui_rect_t r) {
+    for(int y = r.y; y < r.y + r.h; y++) {
+        memcpy(fb_row(r.x, y), back + y * fb.width + r.x, r.w * 4);
+    }
+    pixels_flushed += r.w * r.h;
+}
+
+// ========================
+// MAUSZEIGER
+// ========================
+
+static gui_rect_t cursor_rect(void) {
+    return gui_rect_intersect(gui_rect(pointer_x, pointer_y, GUI_CURSOR_W, GUI_CURSOR_H),
+                              screen_rect());
+}
+
+// Save-Under aus dem Back Buffer holen und den Zeiger in den LFB setzen
+static void cursor_draw(void) {
+    gui_rect_t r = cursor_rect();
+    uint32_t row[GUI_CURSOR_W];
+
+    for(int y = 0; y < r.h; y++) {
+        const uint32_t* src = back + (r.y + y) * fb.width + r.x;
+        uint32_t* saved = save_under + y * GUI_CURSOR_W;
+        const char* shape = cursor_shape[r.y + y - pointer_y];
+
+        for(int x = 0; x < r.w; x++) {
+            saved[x] = src[x];
+            char c = shape[r.x + x - pointer_x];
+            row[x] = c == 'X' ? 0x00000000 : c == '.' ? 0x00FFFFFF : src[x];
+        }
+        memcpy(fb_row(r.x, r.y + y), row, r.w * 4);
+    }
+    pointer_visible = 1;
+}
+
+static void cursor_erase(void) {
+    if(!pointer_visible) return;
+    gui_rect_t r = cursor_rect();
+    for(int y = 0; y < r.h; y++) {
+        memcpy(fb_row(r.x, r.y + y), save_under + y * GUI_CURSOR_W, r.w * 4);
+    }
+    pointer_visible = 0;
+}
+
+// Mausbewegung: zwei kleine Rechtecke, kein Neukomponieren
+void gui_cursor_move(int x, int y) {
+    if(!active) return;
+    if(x < 0) x = 0;
+    if(y < 0) y = 0;
+    if(x >= (int)fb.width) x = fb.width - 1;
+    if(y >= (int)fb.height) y = fb.height - 1;
+    if(pointer_visible && x == pointer_x && y == pointer_y) return;
+
+    cursor_erase();
+    pointer_x = x;
+    pointer_y = y;
+    cursor_draw();
+}
+
+// ========================
+// FLUSH
+// ========================
+
+void gui_flush(void) {
+    if(!active || damage_count == 0) return;
+
+    int count = damage_count;
+    damage_count = 0;
+    flush_count++;
+
+    gui_rect_t under_cursor = cursor_rect();
+    int cursor_hit = 0;
+
+    for(int i = 0; i < count; i++) {
+        compose(damage[i]);
+        present(damage[i]);
+        if(!gui_rect_empty(gui_rect_intersect(damage[i], under_cursor))) cursor_hit = 1;
+    }
+    rects_flushed += count;
+
+    // Der Flush hat den Zeiger übermalt - Save-Under ist veraltet
+    if(pointer_visible && cursor_hit) {
+        pointer_visible = 0;
+        cursor_draw();
+    }
+}
+
+void gui_print_stats(void) {
+    kprintf(TXT_NORMAL, "GUI:      %u flushes, %u rects (%u merged), %u KB to LFB\n",
+            flush_count, rects_flushed, rects_merged, pixels_flushed / 256);
+}
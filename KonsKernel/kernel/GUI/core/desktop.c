@@ -0,0 +1,102 @@
+// kernel/GUI/core/desktop.c - einfache Desktop-Sitzung für den Compositor
+#include "gui.h"
+#include "../../drivers/mouse.h"
+#include "../../drivers/keyboard.h"
+#include "../../drivers/screen.h"
+#include "../../drivers/font.h"
+#include "../../time/time.h"
+#include "../../lib/printf.h"
+
+static volatile int quit = 0;
+
+// Kommt über keyboard_poll: nur ESC beendet, alles andere gehört der GUI
+static void desktop_key(uint8_t scancode) {
+    if(scancode == 0x01) quit = 1;
+}
+
+// Nur die Uhrzeile neu zeichnen - eine kleine Damage pro Sekunde
+static void update_clock(gui_window_t* win) {
+    int h, m, s;
+    get_time(&h, &m, &s);
+
+    char text[16];
+    ksnprintf(text, sizeof(text), "%02d:%02d:%02d", h, m, s);
+
+    gui_rect_t line = gui_rect(10, GUI_TITLE_HEIGHT + 10, 8 * FONT_WIDTH, FONT_HEIGHT);
+    gui_window_text(win, line.x, line.y, text, GUI_TEXT_COLOR, GUI_CLIENT_COLOR);
+    gui_window_invalidate(win, line);
+}
+
+void gui_run(void) {
+    if(!gui_init()) {
+        kprint("\nGUI needs a 32 bpp framebuffer (boot via GRUB).\n", TXT_ERROR);
+        return;
+    }
+
+    mouse_init();
+    mouse_set_position(gui_width() / 2, gui_height() / 2);
+
+    gui_window_t* info = gui_window_create(80, 80, 360, 140, "KonsKernel");
+    gui_window_t* clock = gui_window_create(480, 140, 200, 80, "Clock");
+    if(info) {
+        gui_window_text(info, 10, GUI_TITLE_HEIGHT + 10, "Drag windows by the title bar.",
+                        GUI_TEXT_COLOR, GUI_CLIENT_COLOR);
+        gui_window_text(info, 10, GUI_TITLE_HEIGHT + 30, "Only damaged areas are redrawn.",
+                        GUI_TEXT_COLOR, GUI_CLIENT_COLOR);
+        gui_window_text(info, 10, GUI_TITLE_HEIGHT + 70, "ESC returns to the shell.",
+                        GUI_TEXT_COLOR, GUI_CLIENT_COLOR);
+    }
+
+    quit = 0;
+    keyboard_set_grab(desktop_key);
+
+    gui_window_t* drag = 0;
+    int drag_dx = 0;
+    int drag_dy = 0;
+    int last_second = -1;
+
+    while(!quit) {
+        // Die Shell-Hauptschleife steht, solange gui läuft - selbst abholen
+        keyboard_poll();
+
+        mouse_t m;
+        mouse_get_state(&m);
+
+        if(m.buttons & 1) {
+            if(!drag) {
+                gui_window_t* win = gui_window_at(m.x, m.y);
+                if(win) {
+                    gui_window_raise(win);
+                    if(gui_window_in_title(win, m.x, m.y)) {
+                        drag = win;
+                        drag_dx = m.x - win->frame.x;
+                        drag_dy = m.y - win->frame.y;
+                    }
+                }
+            } else {
+                gui_window_move(drag, m.x - drag_dx, m.y - drag_dy);
+            }
+        } else {
+            drag = 0;
+        }
+
+        if(clock) {
+            int h, min, s;
+            get_time(&h, &min, &s);
+            if(s != last_second) {
+                last_second = s;
+                update_clock(clock);
+            }
+        }
+
+        gui_flush();
+        gui_cursor_move(m.x, m.y);
+        asm volatile("hlt");
+    }
+
+    keyboard_set_grab(0);
+    gui_window_destroy(clock);
+    gui_window_destroy(info);
+    gui_shutdown();
+    gui_print_stats();
+}
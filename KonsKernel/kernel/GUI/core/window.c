@@ -0,0 +1,136 @@
+// kernel/GUI/core/window.c - Fenster mit eigener Fläche
+#include "gui.h"
+#include "../../drivers/font.h"
+#include "../../memory/heap.h"
+#include "../../lib/mem.h"
+
+// Unterstes Fenster zuerst, jedes zeigt auf das darüberliegende
+static gui_window_t* bottom = 0;
+
+gui_window_t* gui_window_bottom(void) {
+    return bottom;
+}
+
+static void unlink(gui_window_t* win) {
+    gui_window_t** link = &bottom;
+    while(*link && *link != win) link = &(*link)->next;
+    if(*link) *link = win->next;
+    win->next = 0;
+}
+
+static void link_top(gui_window_t* win) {
+    gui_window_t** link = &bottom;
+    while(*link) link = &(*link)->next;
+    *link = win;
+    win->next = 0;
+}
+
+// Rahmen, Titelleiste und leere Client-Fläche
+static void decorate(gui_window_t* win) {
+    int w = win->frame.w;
+    int h = win->frame.h;
+
+    gui_window_fill(win, gui_rect(0, 0, w, h), GUI_FRAME_COLOR);
+    gui_window_fill(win, gui_rect(1, 1, w - 2, GUI_TITLE_HEIGHT - 1), GUI_TITLE_COLOR);
+    gui_window_fill(win, gui_rect(1, GUI_TITLE_HEIGHT, w - 2, h - GUI_TITLE_HEIGHT - 1),
+                    GUI_CLIENT_COLOR);
+    gui_window_text(win, 6, (GUI_TITLE_HEIGHT - FONT_HEIGHT) / 2, win->title,
+                    GUI_TITLE_TEXT, GUI_TITLE_COLOR);
+}
+
+gui_window_t* gui_window_create(int x, int y, int w, int h, const char* title) {
+    if(w < 16 || h < GUI_TITLE_HEIGHT + 2) return 0;
+
+    gui_window_t* win = (gui_window_t*)kmalloc_safe(sizeof(gui_window_t));
+    if(!win) return 0;
+    win->pixels = (uint32_t*)kmalloc_safe(w * h * 4);
+    if(!win->pixels) {
+        kfree_safe(win);
+        return 0;
+    }
+
+    win->frame = gui_rect(x, y, w, h);
+    int i = 0;
+    while(title[i] && i < (int)sizeof(win->title) - 1) {
+        win->title[i] = title[i];
+        i++;
+    }
+    win->title[i] = '\0';
+
+    decorate(win);
+    link_top(win);
+    gui_damage(win->frame);
+    return win;
+}
+
+void gui_window_destroy(gui_window_t* win) {
+    if(!win) return;
+    unlink(win);
+    gui_damage(win->frame);
+    kfree_safe(win->pixels);
+    kfree_safe(win);
+}
+
+// Alte und neue Fläche beschädigen - den Rest erledigt der Compositor
+void gui_window_move(gui_window_t* win, int x, int y) {
+    if(x == win->frame.x && y == win->frame.y) return;
+    gui_damage(win->frame);
+    win->frame.x = x;
+    win->frame.y = y;
+    gui_damage(win->frame);
+}
+
+void gui_window_raise(gui_window_t* win) {
+    if(!win->next) return;      // liegt schon oben
+    unlink(win);
+    link_top(win);
+    gui_damage(win->frame);
+}
+
+// Oberstes Fenster unter dem Punkt
+gui_window_t* gui_window_at(int x, int y) {
+    gui_window_t* hit = 0;
+    for(gui_window_t* win = bottom; win; win = win->next) {
+        if(gui_rect_contains(win->frame, x, y)) hit = win;
+    }
+    return hit;
+}
+
+int gui_window_in_title(gui_window_t* win, int x, int y) {
+    return gui_rect_contains(gui_rect(win->frame.x, win->frame.y, win->frame.w, GUI_TITLE_HEIGHT),
+                             x, y);
+}
+
+// ========================
+// ZEICHNEN (Fensterkoordinaten)
+// ========================
+
+void gui_window_fill(gui_window_t* win, gui_rect_t r, uint32_t color) {
+    r = gui_rect_intersect(r, gui_rect(0, 0, win->frame.w, win->frame.h));
+    for(int y = r.y; y < r.y + r.h; y++) {
+        uint32_t* row = win->pixels + y * win->frame.w + r.x;
+        for(int x = 0; x < r.w; x++) row[x] = color;
+    }
+}
+
+void gui_window_text(gui_window_t* win, int x, int y, const char* text, uint32_t fg, uint32_t bg) {
+    for(; *text; text++, x += FONT_WIDTH) {
+        if(x + FONT_WIDTH > win->frame.w) break;
+        const uint8_t* glyph = font8x16[(uint8_t)*text & (FONT_GLYPHS - 1)];
+
+        for(int row = 0; row < FONT_HEIGHT; row++) {
+            if(y + row < 0 || y + row >= win->frame.h) continue;
+            uint32_t* dest = win->pixels + (y + row) * win->frame.w + x;
+            for(int i = 0; i < FONT_WIDTH; i++) {
+                dest[i] = (glyph[row] & (0x80 >> i)) ? fg : bg;
+            }
+        }
+    }
+}
+
+void gui_window_invalidate(gui_window_t* win, gui_rect_t r) {
+    r = gui_rect_intersect(r, gui_rect(0, 0, win->frame.w, win->frame.h));
+    r.x += win->frame.x;
+    r.y += win->frame.y;
+    gui_damage(r);
+}
@@ -0,0 +1,106 @@
+// kernel/GUI/include/gui.h
+#ifndef KERNEL_GUI_GUI_H
+#define KERNEL_GUI_GUI_H
+
+#include <stdint.h>
+
+// ========================
+// GUI KONSTANTEN
+// ========================
+// Farben als 0x00RRGGBB (Standard-Layout der 32-bpp VBE-Modi)
+#define GUI_DESKTOP_COLOR   0x00305070
+#define GUI_TITLE_COLOR     0x00204A87
+#define GUI_TITLE_TEXT      0x00FFFFFF
+#define GUI_FRAME_COLOR     0x00101010
+#define GUI_CLIENT_COLOR    0x00D0D0D0
+#define GUI_TEXT_COLOR      0x00000000
+
+#define GUI_TITLE_HEIGHT    20
+#define GUI_MAX_DAMAGE      32      // danach wird zusammengefasst
+#define GUI_CURSOR_W        12
+#define GUI_CURSOR_H        19
+
+// ========================
+// RECHTECKE
+// ========================
+typedef struct {
+    int x, y;
+    int w, h;
+} gui_rect_t;
+
+static inline gui_rect_t gui_rect(int x, int y, int w, int h) {
+    gui_rect_t r = { x, y, w, h };
+    return r;
+}
+
+static inline int gui_rect_empty(gui_rect_t r) {
+    return r.w <= 0 || r.h <= 0;
+}
+
+static inline gui_rect_t gui_rect_intersect(gui_rect_t a, gui_rect_t b) {
+    int x0 = a.x > b.x ? a.x : b.x;
+    int y0 = a.y > b.y ? a.y : b.y;
+    int x1 = (a.x + a.w) < (b.x + b.w) ? (a.x + a.w) : (b.x + b.w);
+    int y1 = (a.y + a.h) < (b.y + b.h) ? (a.y + a.h) : (b.y + b.h);
+    return gui_rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+static inline gui_rect_t gui_rect_union(gui_rect_t a, gui_rect_t b) {
+    int x0 = a.x < b.x ? a.x : b.x;
+    int y0 = a.y < b.y ? a.y : b.y;
+    int x1 = (a.x + a.w) > (b.x + b.w) ? (a.x + a.w) : (b.x + b.w);
+    int y1 = (a.y + a.h) > (b.y + b.h) ? (a.y + a.h) : (b.y + b.h);
+    return gui_rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+static inline int gui_rect_contains(gui_rect_t r, int x, int y) {
+    return x >= r.x && y >= r.y && x < r.x + r.w && y < r.y + r.h;
+}
+
+// ========================
+// FENSTER
+// ========================
+typedef struct gui_window {
+    gui_rect_t frame;           // Bildschirmposition inkl. Rahmen und Titel
+    uint32_t* pixels;           // eigene Fläche, frame.w * frame.h
+    char title[32];
+    struct gui_window* next;    // nächsthöheres Fenster (Z-Reihenfolge)
+} gui_window_t;
+
+// window.c
+gui_window_t* gui_window_create(int x, int y, int w, int h, const char* title);
+void gui_window_destroy(gui_window_t* win);
+void gui_window_move(gui_window_t* win, int x, int y);
+void gui_window_raise(gui_window_t* win);
+gui_window_t* gui_window_at(int x, int y);
+gui_window_t* gui_window_bottom(void);
+int gui_window_in_title(gui_window_t* win, int x, int y);
+
+// Zeichnen in Fensterkoordinaten, danach gui_window_invalidate
+void gui_window_fill(gui_window_t* win, gui_rect_t r, uint32_t color);
+void gui_window_text(gui_window_t* win, int x, int y, const char* text, uint32_t fg, uint32_t bg);
+void gui_window_invalidate(gui_window_t* win, gui_rect_t r);
+
+// ========================
+// COMPOSITOR
+// ========================
+// compositor.c - Back Buffer, Damage-Rechtecke, Mauszeiger (Save-Under)
+int gui_init(void);
+void gui_shutdown(void);
+int gui_active(void);
+int gui_width(void);
+int gui_height(void);
+
+// Bildschirmbereich als geändert markieren (wird beim Flush neu komponiert)
+void gui_damage(gui_rect_t r);
+
+// Nur beschädigte Bereiche komponieren und in den LFB kopieren
+void gui_flush(void);
+
+void gui_cursor_move(int x, int y);
+void gui_print_stats(void);
+
+// desktop.c - interaktive Sitzung (Shell-Befehl 'gui'), ESC beendet
+void gui_run(void);
+
+#endif
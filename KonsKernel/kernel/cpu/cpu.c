@@ -0,0 +1,112 @@
+// kernel/cpu/cpu.c
+#include "cpu.h"
+#include "../drivers/screen.h"
+#include "../lib/printf.h"
+#include "../lib/utils.h"
+
+struct cpu_features cpu;
+
+// CPUID gibt es, wenn sich EFLAGS.ID (Bit 21) umschalten lässt
+static int cpuid_supported(void) {
+    uint32_t before, after;
+    asm volatile(
+        "pushfl\n"
+        "pushfl\n"
+        "popl %0\n"
+        "movl %0, %1\n"
+        "xorl $0x200000, %0\n"
+        "pushl %0\n"
+        "popfl\n"
+        "pushfl\n"
+        "popl %0\n"
+        "popfl\n"
+        : "=&r"(after), "=&r"(before));
+    return ((before ^ after) & 0x200000) != 0;
+}
+
+// TSC gegen PIT Kanal 2 messen: 10 ms One-Shot, Gate über Port 0x61
+#define PIT_HZ           1193182
+#define CALIBRATE_MS     10
+
+static uint32_t calibrate_tsc(void) {
+    uint16_t latch = PIT_HZ / (1000 / CALIBRATE_MS);
+
+    // Gate an, Lautsprecher aus
+    outb(0x61, (inb(0x61) & ~0x02) | 0x01);
+
+    // Kanal 2, lo/hi Byte, Mode 0 (Interrupt on Terminal Count)
+    outb(0x43, 0xB0);
+    outb(0x42, latch & 0xFF);
+    outb(0x42, latch >> 8);
+
+    uint64_t start = rdtsc();
+    uint32_t spins = 0;
+    while(!(inb(0x61) & 0x20)) {
+        // Kein PIT (oder kaputtes Gate) - nicht ewig warten
+        if(++spins > 10000000) return 0;
+    }
+    uint32_t cycles = (uint32_t)(rdtsc() - start);
+
+    return cycles / CALIBRATE_MS;
+}
+
+void cpu_init(void) {
+    uint32_t a, b, c, d;
+
+    cpu.vendor[0] = '\0';
+    if(!cpuid_supported()) return;
+
+    cpuid(0, &a, &b, &c, &d);
+    uint32_t max_leaf = a;
+    *(uint32_t*)&cpu.vendor[0] = b;
+    *(uint32_t*)&cpu.vendor[4] = d;
+    *(uint32_t*)&cpu.vendor[8] = c;
+    cpu.vendor[12] = '\0';
+
+    if(max_leaf < 1) return;
+    cpuid(1, &a, &b, &c, &d);
+
+    cpu.family = (a >> 8) & 0x0F;
+    cpu.model = (a >> 4) & 0x0F;
+
+    cpu.fpu    = (d >> 0) & 1;
+    cpu.pse    = (d >> 3) & 1;
+    cpu.tsc    = (d >> 4) & 1;
+    cpu.msr    = (d >> 5) & 1;
+    cpu.apic   = (d >> 9) & 1;
+    cpu.pat    = (d >> 16) & 1;
+    cpu.fxsr   = (d >> 24) & 1;
+    cpu.sse    = (d >> 25) & 1;
+    cpu.sse2   = (d >> 26) & 1;
+    cpu.sse3   = (c >> 0) & 1;
+    cpu.ssse3  = (c >> 9) & 1;
+    cpu.sse41  = (c >> 19) & 1;
+    cpu.sse42  = (c >> 20) & 1;
+    cpu.popcnt = (c >> 23) & 1;
+    cpu.avx    = (c >> 28) & 1;
+
+    cpu.tsc_khz = cpu.tsc ? calibrate_tsc() : 0;
+}
+
+static void print_flag(const char* name, int present) {
+    kprint(name, present ? TXT_SUCCESS : TXT_GRAY);
+    kprint(" ", TXT_NORMAL);
+}
+
+void cpu_print_info(void) {
+    kprint("CPU:      ", TXT_NORMAL);
+    kprint(cpu.vendor[0] ? cpu.vendor : "unknown (no CPUID)", TXT_INFO);
+    kprint("\nFeatures: ", TXT_NORMAL);
+    print_flag("fpu", cpu.fpu);
+    print_flag("pse", cpu.pse);
+    print_flag("tsc", cpu.tsc);
+    print_flag("pat", cpu.pat);
+    print_flag("apic", cpu.apic);
+    print_flag("fxsr", cpu.fxsr);
+    print_flag("sse", cpu.sse);
+    print_flag("sse2", cpu.sse2);
+    print_flag("sse4.2", cpu.sse42);
+    print_flag("avx", cpu.avx);
+    if(cpu.tsc_khz) kprintf(TXT_NORMAL, "\nTSC:      %C%u MHz", TXT_INFO, cpu.tsc_khz / 1000);
+    kprint("\n", TXT_NORMAL);
+}
@@ -0,0 +1,132 @@
+// kernel/cpu/cpu.h
+#ifndef KERNEL_CPU_CPU_H
+#define KERNEL_CPU_CPU_H
+
+#include <stdint.h>
+
+// CR0 / CR4 Bits
+#define CR0_MP          (1 << 1)
+#define CR0_NW          (1 << 29)
+#define CR0_CD          (1 << 30)
+#define CR0_EM          (1 << 2)
+#define CR0_TS          (1 << 3)
+#define CR0_PG          (1u << 31)
+#define CR4_PSE         (1 << 4)
+#define CR4_OSFXSR      (1 << 9)
+#define CR4_OSXMMEXCPT  (1 << 10)
+
+// MSRs
+#define MSR_PAT         0x277
+
+// CPU Features (aus CPUID Leaf 1)
+struct cpu_features {
+    char vendor[13];
+    uint8_t family;
+    uint8_t model;
+    int fpu;
+    int pse;
+    int tsc;
+    int msr;
+    int apic;
+    int pat;
+    int fxsr;
+    int sse;
+    int sse2;
+    int sse3;
+    int ssse3;
+    int sse41;
+    int sse42;
+    int popcnt;
+    int avx;
+    uint32_t tsc_khz;   // kalibriert gegen den PIT, 0 = unbekannt
+};
+
+extern struct cpu_features cpu;
+
+void cpu_init(void);
+void cpu_print_info(void);
+
+static inline void cpuid(uint32_t leaf, uint32_t* a, uint32_t* b, uint32_t* c, uint32_t* d) {
+    asm volatile("cpuid" : "=a"(*a), "=b"(*b), "=c"(*c), "=d"(*d) : "a"(leaf), "c"(0));
+}
+
+// Interrupts sperren und alten Zustand (EFLAGS) zurückgeben
+static inline uint32_t irq_save(void) {
+    uint32_t flags;
+    asm volatile("pushfl\n popl %0\n cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+static inline void irq_restore(uint32_t flags) {
+    asm volatile("pushl %0\n popfl" : : "r"(flags) : "memory", "cc");
+}
+
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline uint64_t rdmsr(uint32_t msr) {
+    uint32_t lo, hi;
+    asm volatile("rdmsr" : "=a"(lo), "=d"(hi) : "c"(msr));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void wrmsr(uint32_t msr, uint64_t value) {
+    asm volatile("wrmsr" : : "c"(msr), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)) : "memory");
+}
+
+// 64/32 Division ohne libgcc (__udivdi3): zwei divl-Schritte
+static inline uint64_t div64_32(uint64_t n, uint32_t d) {
+    uint32_t hi = (uint32_t)(n >> 32);
+    uint32_t q_hi = hi / d;
+    uint32_t rem = hi % d;
+    uint32_t q_lo;
+    asm("divl %4" : "=a"(q_lo), "=d"(rem) : "a"((uint32_t)n), "d"(rem), "rm"(d));
+    return ((uint64_t)q_hi << 32) | q_lo;
+}
+
+// TSC-Takte in Mikrosekunden (0 wenn nicht kalibriert)
+static inline uint32_t tsc_to_us(uint64_t cycles, uint32_t tsc_khz) {
+    if(tsc_khz == 0) return 0;
+    return (uint32_t)div64_32(cycles * 1000, tsc_khz);
+}
+
+static inline uint32_t read_cr0(void) {
+    uint32_t value;
+    asm volatile("mov %%cr0, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr0(uint32_t value) {
+    asm volatile("mov %0, %%cr0" : : "r"(value) : "memory");
+}
+
+static inline uint32_t read_cr2(void) {
+    uint32_t value;
+    asm volatile("mov %%cr2, %0" : "=r"(value));
+    return value;
+}
+
+static inline uint32_t read_cr3(void) {
+    uint32_t value;
+    asm volatile("mov %%cr3, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr3(uint32_t value) {
+    asm volatile("mov %0, %%cr3" : : "r"(value) : "memory");
+}
+
+static inline uint32_t read_cr4(void) {
+    uint32_t value;
+    asm volatile("mov %%cr4, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr4(uint32_t value) {
+    asm volatile("mov %0, %%cr4" : : "r"(value) : "memory");
+}
+
+#endif
@@ -0,0 +1,164 @@
+// kernel/cpu/fpu.c - FPU/SSE Freischaltung und Lazy Context Switching
+#include "fpu.h"
+#include "cpu.h"
+#include "../drivers/screen.h"
+#include "../lib/printf.h"
+#include "../lib/utils.h"
+
+#define MXCSR_DEFAULT 0x1F80   // alle SIMD-Exceptions maskiert
+
+static int sse_enabled = 0;
+
+// Zustand nach fninit/ldmxcsr - Vorlage für neue Kontexte
+static struct fpu_context fpu_init_state;
+
+// Kontext der Hauptschleife (bis es Threads gibt, der einzige)
+static struct fpu_context fpu_kernel_ctx;
+
+// fpu_current: wer gerade läuft, fpu_owner: wessen Zustand in den Registern liegt
+static struct fpu_context* fpu_current = 0;
+static struct fpu_context* fpu_owner = 0;
+
+// Sicherungen für verschachtelte kernel_fpu_begin (IRQ unterbricht FPU-Code)
+static struct fpu_context fpu_nest[FPU_NEST_MAX];
+static volatile int fpu_depth = 0;
+
+// Statistik
+static uint32_t nm_faults = 0;
+static uint32_t nest_overflows = 0;
+
+static inline void clts(void) {
+    asm volatile("clts");
+}
+
+static inline void stts(void) {
+    write_cr0(read_cr0() | CR0_TS);
+}
+
+static inline void fxsave(struct fpu_context* ctx) {
+    asm volatile("fxsave (%0)" : : "r"(ctx->fxsave) : "memory");
+}
+
+static inline void fxrstor(struct fpu_context* ctx) {
+    asm volatile("fxrstor (%0)" : : "r"(ctx->fxsave) : "memory");
+}
+
+// ========================
+// INIT
+// ========================
+void fpu_init(void) {
+    if(!cpu.fpu) return;
+
+    // x87 nativ: EM aus, MP an (WAIT/FWAIT beachtet TS), TS aus
+    uint32_t cr0 = read_cr0();
+    cr0 &= ~(CR0_EM | CR0_TS);
+    cr0 |= CR0_MP;
+    write_cr0(cr0);
+    asm volatile("fninit");
+
+    if(!cpu.fxsr || !cpu.sse) return;
+
+    // OSFXSR: FXSAVE/FXRSTOR sichern XMM, SSE-Befehle erlaubt
+    // OSXMMEXCPT: unmaskierte SIMD-Fehler kommen als #XM statt #UD
+    write_cr4(read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+
+    uint32_t mxcsr = MXCSR_DEFAULT;
+    asm volatile("ldmxcsr %0" : : "m"(mxcsr));
+
+    // AVX wird nur erkannt, nicht eingeschaltet: FXSAVE sichert die oberen
+    // YMM-Hälften nicht, dafür bräuchte es XSAVE und XCR0.
+    fxsave(&fpu_init_state);
+    fpu_kernel_ctx = fpu_init_state;
+
+    fpu_current = &fpu_kernel_ctx;
+    fpu_owner = &fpu_kernel_ctx;
+    sse_enabled = 1;
+}
+
+int fpu_sse_enabled(void) {
+    return sse_enabled;
+}
+
+void fpu_context_init(struct fpu_context* ctx) {
+    *ctx = fpu_init_state;
+}
+
+// ========================
+// KERNEL FPU SECTIONS
+// ========================
+int kernel_fpu_begin(void) {
+    if(!sse_enabled) return 0;
+
+    uint32_t flags = irq_save();
+
+    if(fpu_depth >= FPU_NEST_MAX) {
+        nest_overflows++;
+        irq_restore(flags);
+        return 0;
+    }
+
+    clts();
+    if(fpu_depth == 0) {
+        // Registerinhalt gehört einem Kontext - einmal wegsichern,
+        // zurückgeladen wird erst, wenn der Kontext die FPU wieder anfasst
+        if(fpu_owner) {
+            fxsave(fpu_owner);
+            fpu_owner = 0;
+        }
+    } else {
+        // Wir unterbrechen eine andere Kernel-FPU-Sektion
+        fxsave(&fpu_nest[fpu_depth - 1]);
+    }
+    fpu_depth++;
+
+    irq_restore(flags);
+    return 1;
+}
+
+void kernel_fpu_end(void) {
+    uint32_t flags = irq_save();
+
+    fpu_depth--;
+    if(fpu_depth > 0) {
+        fxrstor(&fpu_nest[fpu_depth - 1]);
+    } else {
+        // Register gehören niemandem mehr - nächster Zugriff löst #NM aus
+        stts();
+    }
+
+    irq_restore(flags);
+}
+
+// ========================
+// LAZY SWITCH
+// ========================
+void fpu_switch(struct fpu_context* next) {
+    if(!sse_enabled) return;
+
+    fpu_current = next;
+    if(fpu_owner == next) clts();
+    else stts();
+}
+
+// #NM (INT 7): FPU-Befehl bei gesetztem CR0.TS
+void fpu_handle_nm(void) {
+    nm_faults++;
+    clts();
+
+    if(fpu_owner == fpu_current) return;
+
+    if(fpu_owner) fxsave(fpu_owner);
+    if(fpu_current) fxrstor(fpu_current);
+    fpu_owner = fpu_current;
+}
+
+void fpu_print_info(void) {
+    kprint("SIMD:     ", TXT_NORMAL);
+    if(sse_enabled) kprint("SSE enabled (FXSR, lazy #NM)", TXT_SUCCESS);
+    else if(cpu.fpu) kprint("x87 only", TXT_YELLOW);
+    else kprint("none", TXT_GRAY);
+
+    kprintf(TXT_NORMAL, "  #NM: %C%u", TXT_INFO, nm_faults);
+    if(nest_overflows) kprintf(TXT_NORMAL, "  nest overflows: %C%u", TXT_WARNING, nest_overflows);
+    kprint("\n", TXT_NORMAL);
+}
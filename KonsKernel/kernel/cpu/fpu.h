@@ -0,0 +1,31 @@
+// kernel/cpu/fpu.h
+#ifndef KERNEL_CPU_FPU_H
+#define KERNEL_CPU_FPU_H
+
+#include <stdint.h>
+
+// Verschachtelungstiefe für kernel_fpu_begin (Hauptschleife + IRQs)
+#define FPU_NEST_MAX 4
+
+// FXSAVE-Bereich: 512 Bytes, muss 16-Byte aligned sein
+struct fpu_context {
+    uint8_t fxsave[512];
+} __attribute__((aligned(16)));
+
+void fpu_init(void);
+int fpu_sse_enabled(void);
+
+// Vektorregister im Kernel benutzen (auch aus IRQ-Handlern).
+// Rückgabe 0: kein SSE - Aufrufer nimmt den skalaren Pfad und ruft
+// kernel_fpu_end NICHT auf.
+int kernel_fpu_begin(void);
+void kernel_fpu_end(void);
+
+// Lazy Switching: nur den Besitzer umsetzen, gespeichert wird erst bei #NM
+void fpu_context_init(struct fpu_context* ctx);
+void fpu_switch(struct fpu_context* next);
+void fpu_handle_nm(void);
+
+void fpu_print_info(void);
+
+#endif
@@ -0,0 +1,122 @@
+// kernel/cpu/work.c - Deferred Work (Bottom Halves)
+#include "work.h"
+#include "cpu.h"
+#include "../lib/printf.h"
+#include "../drivers/screen.h"
+
+static struct work* queue_head[WORK_VECTORS];
+static struct work* queue_tail[WORK_VECTORS];
+static volatile uint32_t pending_vectors = 0;   // Bit n = Warteschlange n nicht leer
+static volatile int running = 0;
+static struct work* all_work = 0;
+
+void work_init(struct work* w, const char* name, int vector, void (*fn)(void* arg), void* arg) {
+    w->fn = fn;
+    w->arg = arg;
+    w->name = name;
+    w->vector = (vector >= 0 && vector < WORK_VECTORS) ? vector : WORK_VECTORS - 1;
+    w->pending = 0;
+    w->next = 0;
+    w->queued_at = 0;
+    w->latency_total = 0;
+    w->latency_max = 0;
+    w->run_total = 0;
+    w->runs = 0;
+    w->coalesced = 0;
+
+    uint32_t flags = irq_save();
+    w->all = all_work;
+    all_work = w;
+    irq_restore(flags);
+}
+
+int schedule_work(struct work* w) {
+    uint32_t flags = irq_save();
+
+    if(w->pending) {
+        w->coalesced++;
+        irq_restore(flags);
+        return 0;
+    }
+
+    w->pending = 1;
+    w->next = 0;
+    w->queued_at = cpu.tsc ? rdtsc() : 0;
+
+    if(queue_tail[w->vector]) queue_tail[w->vector]->next = w;
+    else queue_head[w->vector] = w;
+    queue_tail[w->vector] = w;
+    pending_vectors |= 1u << w->vector;
+
+    irq_restore(flags);
+    return 1;
+}
+
+int work_pending(void) {
+    return pending_vectors != 0;
+}
+
+// Nächsten Eintrag aus der Warteschlange des kleinsten Vektors nehmen (IF=0)
+static struct work* dequeue(void) {
+    uint32_t mask = pending_vectors;
+    if(!mask) return 0;
+
+    int v = __builtin_ctz(mask);
+    struct work* w = queue_head[v];
+    queue_head[v] = w->next;
+    if(!queue_head[v]) {
+        queue_tail[v] = 0;
+        pending_vectors = mask & ~(1u << v);
+    }
+    w->next = 0;
+    w->pending = 0;
+    return w;
+}
+
+void work_run(void) {
+    uint32_t flags = irq_save();
+    if(running) {
+        irq_restore(flags);
+        return;
+    }
+    running = 1;
+
+    struct work* w;
+    while((w = dequeue()) != 0) {
+        // Ohne TSC nur Läufe zählen, Latenz und Laufzeit bleiben 0
+        uint64_t start = cpu.tsc ? rdtsc() : 0;
+        uint64_t latency = start - w->queued_at;
+
+        asm volatile("sti" ::: "memory");
+        w->fn(w->arg);
+        asm volatile("cli" ::: "memory");
+
+        if(cpu.tsc) w->run_total += rdtsc() - start;
+        w->latency_total += latency;
+        if(latency > w->latency_max) w->latency_max = latency;
+        w->runs++;
+    }
+
+    running = 0;
+    irq_restore(flags);
+}
+
+void work_irq_exit(void) {
+    if(pending_vectors && !running) work_run();
+}
+
+void work_print_stats(void) {
+    kprint("\n=== Deferred Work ===\n", TXT_INFO);
+    kprint("IRQ  Name          Runs  Coalesced  Avg lat us  Max lat us  Avg run us\n", TXT_NORMAL);
+
+    for(struct work* w = all_work; w; w = w->all) {
+        uint32_t runs = w->runs ? w->runs : 1;
+        kprintf(TXT_NORMAL, "%3u  %-12s %5u  %9u  %10u  %10u  %10u\n",
+                w->vector, w->name, w->runs, w->coalesced,
+                tsc_to_us(div64_32(w->latency_total, runs), cpu.tsc_khz),
+                tsc_to_us(w->latency_max, cpu.tsc_khz),
+                tsc_to_us(div64_32(w->run_total, runs), cpu.tsc_khz));
+    }
+
+    if(cpu.tsc_khz == 0) kprint("(TSC not calibrated - times shown as 0)\n", TXT_WARNING);
+}
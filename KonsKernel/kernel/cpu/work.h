@@ -0,0 +1,51 @@
+// kernel/cpu/work.h
+#ifndef KERNEL_CPU_WORK_H
+#define KERNEL_CPU_WORK_H
+
+#include <stdint.h>
+
+// ========================
+// DEFERRED WORK (Bottom Halves)
+// ========================
+// Der IRQ-Handler (Top Half) reiht nur ein, die eigentliche Arbeit läuft
+// danach mit offenen Interrupts - beim Verlassen des IRQs oder im Idle-Loop.
+// Pro Vektor eine FIFO, niedrigere Vektoren werden zuerst abgearbeitet.
+#define WORK_VECTORS    16
+
+struct work {
+    void (*fn)(void* arg);
+    void* arg;
+    const char* name;
+    uint8_t vector;             // IRQ-Nummer der Quelle
+    volatile uint8_t pending;   // liegt in der Warteschlange
+    struct work* next;          // Warteschlange
+    struct work* all;           // alle bekannten Einträge (Statistik)
+
+    // Statistik in TSC-Takten
+    uint64_t queued_at;
+    uint64_t latency_total;     // Einreihen -> Start
+    uint64_t latency_max;
+    uint64_t run_total;         // Laufzeit von fn
+    uint32_t runs;
+    uint32_t coalesced;         // erneut eingereiht, bevor sie lief
+};
+
+// Einmalig pro Eintrag, außerhalb von IRQs
+void work_init(struct work* w, const char* name, int vector, void (*fn)(void* arg), void* arg);
+
+// Aus jedem Kontext aufrufbar. Liegt w schon in der Warteschlange, läuft sie
+// nur einmal (Rückgabe 0).
+int schedule_work(struct work* w);
+
+int work_pending(void);
+
+// Warteschlangen abarbeiten, fn läuft mit offenen Interrupts. Nicht reentrant:
+// ein verschachtelter Aufruf kehrt sofort zurück.
+void work_run(void);
+
+// Ende von irq_handler, nach dem EOI
+void work_irq_exit(void);
+
+void work_print_stats(void);
+
+#endif
@@ -2,18 +2,161 @@
 #include "acpi.h"
 #include "../lib/utils.h"
 #include "screen.h"
+#include "../lib/log.h"
+#include "../memory/paging.h"
 #include <stddef.h>
 
 static struct acpi_rsdp* rsdp = NULL;
+static struct acpi_rsdt* rsdt = NULL;
 static struct acpi_fadt* fadt = NULL;
 
+struct acpi_madt_info acpi_madt_info;
+struct acpi_ecam_info acpi_ecam;
+
+// ACPI-Tabellen liegen oft hinter dem RAM-Identity-Mapping (ACPI Reclaim)
+static void* acpi_map(uint32_t phys, uint32_t size) {
+    uint32_t last = phys + size - 1;
+    for (uint32_t addr = phys & PAGE_FRAME; ; addr += 0x1000) {
+        if (virt_to_phys(addr) == PAGING_NO_MAPPING) {
+            map_mmio(addr, 0x1000, MMIO_UNCACHED);
+        }
+        if (addr == (last & PAGE_FRAME)) break;
+    }
+    return (void*)phys;
+}
+
+// Header zuerst, dann die ganze Tabelle (Länge steht erst im Header)
+static struct acpi_sdt_header* acpi_map_table(uint32_t phys) {
+    struct acpi_sdt_header* header = acpi_map(phys, sizeof(struct acpi_sdt_header));
+    return acpi_map(phys, header->length);
+}
+
+static int acpi_checksum(const void* table, uint32_t length) {
+    uint8_t sum = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        sum += ((const uint8_t*)table)[i];
+    }
+    return sum == 0;
+}
+
+struct acpi_sdt_header* acpi_find_table(const char* signature) {
+    if (!rsdt) return NULL;
+
+    int entries = (rsdt->header.length - sizeof(rsdt->header)) / 4;
+    for (int i = 0; i < entries; i++) {
+        struct acpi_sdt_header* header = acpi_map_table(rsdt->entries[i]);
+
+        if (header->signature[0] == signature[0] && header->signature[1] == signature[1] &&
+            header->signature[2] == signature[2] && header->signature[3] == signature[3]) {
+            if (!acpi_checksum(header, header->length)) {
+                klog(LOG_WARN, "ACPI: %c%c%c%c checksum mismatch", signature[0],
+                     signature[1], signature[2], signature[3]);
+            }
+            return header;
+        }
+    }
+    return NULL;
+}
+
+// ========================
+// MCFG
+// ========================
+static void acpi_parse_mcfg(void) {
+    struct acpi_mcfg* mcfg = (struct acpi_mcfg*)acpi_find_table("MCFG");
+    if (!mcfg) return;
+
+    int count = (mcfg->header.length - sizeof(struct acpi_mcfg)) / sizeof(struct acpi_mcfg_entry);
+    for (int i = 0; i < count; i++) {
+        struct acpi_mcfg_entry* e = &mcfg->entries[i];
+        if (e->segment != 0) continue;
+        if ((e->base >> 32) != 0) {
+            klog(LOG_WARN, "ACPI: ECAM above 4 GB, using port I/O");
+            continue;
+        }
+
+        // Die Basis gilt für Bus 0 - auf den ersten Bus des Bereichs verschieben
+        acpi_ecam.base = (uint32_t)e->base + ((uint32_t)e->start_bus << 20);
+        acpi_ecam.start_bus = e->start_bus;
+        acpi_ecam.end_bus = e->end_bus;
+        acpi_ecam.present = 1;
+        klog(LOG_INFO, "ACPI: MCFG ECAM at %08X, bus %u-%u", (uint32_t)e->base,
+             e->start_bus, e->end_bus);
+        return;
+    }
+}
+
+// ========================
+// MADT
+// ========================
+static void acpi_parse_madt(void) {
+    struct acpi_madt_info* info = &acpi_madt_info;
+
+    for (int i = 0; i < 16; i++) {
+        info->isa_gsi[i] = i;
+        info->isa_flags[i] = 0;
+    }
+    info->nmi_lint = -1;
+
+    struct acpi_madt* madt = (struct acpi_madt*)acpi_find_table("APIC");
+    if (!madt) {
+        klog(LOG_WARN, "ACPI: no MADT, staying on the 8259 PIC");
+        return;
+    }
+
+    info->present = 1;
+    info->lapic_address = madt->lapic_address;
+    info->pcat_compat = madt->flags & MADT_PCAT_COMPAT;
+
+    uint8_t* entry = madt->entries;
+    uint8_t* end = (uint8_t*)madt + madt->header.length;
+
+    while (entry + sizeof(struct madt_entry) <= end) {
+        struct madt_entry* e = (struct madt_entry*)entry;
+        if (e->length < sizeof(struct madt_entry)) break;
+
+        if (e->type == MADT_LAPIC) {
+            struct madt_lapic* lapic = (struct madt_lapic*)e;
+            if ((lapic->flags & 1) && info->cpu_count < ACPI_MAX_CPUS) {
+                info->cpu_apic_id[info->cpu_count++] = lapic->apic_id;
+            }
+        }
+        else if (e->type == MADT_IOAPIC) {
+            struct madt_ioapic* io = (struct madt_ioapic*)e;
+            if (info->ioapic_count < ACPI_MAX_IOAPICS) {
+                struct acpi_ioapic_info* dst = &info->ioapic[info->ioapic_count++];
+                dst->id = io->ioapic_id;
+                dst->address = io->address;
+                dst->gsi_base = io->gsi_base;
+            }
+        }
+        else if (e->type == MADT_ISO) {
+            struct madt_iso* iso = (struct madt_iso*)e;
+            if (iso->bus == 0 && iso->source < 16) {
+                info->isa_gsi[iso->source] = iso->gsi;
+                info->isa_flags[iso->source] = iso->flags;
+            }
+        }
+        else if (e->type == MADT_LAPIC_NMI) {
+            struct madt_lapic_nmi* nmi = (struct madt_lapic_nmi*)e;
+            info->nmi_lint = nmi->lint;
+        }
+        else if (e->type == MADT_LAPIC_OVERRIDE) {
+            struct madt_lapic_override* ov = (struct madt_lapic_override*)e;
+            if ((ov->address >> 32) == 0) info->lapic_address = (uint32_t)ov->address;
+        }
+
+        entry += e->length;
+    }
+
+    klog(LOG_INFO, "ACPI: MADT %d CPU(s), %d IOAPIC(s), LAPIC at %08X",
+         info->cpu_count, info->ioapic_count, info->lapic_address);
+}
+
 int acpi_is_available(void) {
     return rsdp != NULL;
 }
 
 void acpi_init(void) {
-    kprint("Initializing ACPI... ", TXT_INFO);
-
     // RSDP im BIOS-Bereich suchen (0xE0000 - 0xFFFFF)
     for (uint32_t addr = 0xE0000; addr < 0x100000; addr += 16) {
         char* ptr = (char*)addr;
@@ -28,28 +171,22 @@ void acpi_init(void) {
             }
 
             if ((sum & 0xFF) == 0) {
-                kprint("[OK]\n", TXT_SUCCESS);
-
-                // RSDT durchsuchen nach FADT
-                struct acpi_rsdt* rsdt = (struct acpi_rsdt*)(uint32_t)rsdp->rsdt_address;
-                int entries = (rsdt->header.length - sizeof(rsdt->header)) / 4;
-
-                for (int i = 0; i < entries; i++) {
-                    struct acpi_sdt_header* header = (struct acpi_sdt_header*)(uint32_t)rsdt->entries[i];
-
-                    if (header->signature[0] == 'F' && header->signature[1] == 'A' &&
-                        header->signature[2] == 'C' && header->signature[3] == 'P') {
-                        fadt = (struct acpi_fadt*)header;
-                        kprint("FADT found\n", TXT_SUCCESS);
-                        return;
-                    }
-                }
+                klog(LOG_INFO, "ACPI: RSDP at %08X", addr);
+
+                rsdt = (struct acpi_rsdt*)acpi_map_table(rsdp->rsdt_address);
+                fadt = (struct acpi_fadt*)acpi_find_table("FACP");
+                if (fadt) klog(LOG_INFO, "ACPI: FADT at %08X", (uint32_t)fadt);
+
+                acpi_parse_madt();
+                acpi_parse_mcfg();
+                return;
             }
         }
     }
 
-    kprint("[FAILED]\n", TXT_ERROR);
+    klog(LOG_ERROR, "ACPI: no valid RSDP found");
     rsdp = NULL;
+    acpi_parse_madt();      // setzt nur die ISA-Standardwerte
 }
 
 void acpi_reboot(void) {
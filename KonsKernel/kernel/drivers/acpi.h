@@ -89,8 +89,124 @@ struct acpi_fadt {
     uint32_t x_gpe1_blk;
 } __attribute__((packed));
 
+// ACPI MADT (Multiple APIC Description Table, Signatur "APIC")
+struct acpi_madt {
+    struct acpi_sdt_header header;
+    uint32_t lapic_address;
+    uint32_t flags;         // Bit 0: zusätzlich 8259-PICs vorhanden
+    uint8_t entries[];      // Einträge variabler Länge: type, length, ...
+} __attribute__((packed));
+
+#define MADT_PCAT_COMPAT        0x01
+
+#define MADT_LAPIC              0
+#define MADT_IOAPIC             1
+#define MADT_ISO                2       // Interrupt Source Override
+#define MADT_LAPIC_NMI          4
+#define MADT_LAPIC_OVERRIDE     5
+
+struct madt_entry {
+    uint8_t type;
+    uint8_t length;
+} __attribute__((packed));
+
+struct madt_lapic {
+    struct madt_entry header;
+    uint8_t processor_id;
+    uint8_t apic_id;
+    uint32_t flags;         // Bit 0: CPU aktiv
+} __attribute__((packed));
+
+struct madt_ioapic {
+    struct madt_entry header;
+    uint8_t ioapic_id;
+    uint8_t reserved;
+    uint32_t address;
+    uint32_t gsi_base;
+} __attribute__((packed));
+
+struct madt_iso {
+    struct madt_entry header;
+    uint8_t bus;            // immer 0 (ISA)
+    uint8_t source;         // ISA-IRQ
+    uint32_t gsi;
+    uint16_t flags;         // MPS INTI Flags: Polarität, Triggermodus
+} __attribute__((packed));
+
+struct madt_lapic_nmi {
+    struct madt_entry header;
+    uint8_t processor_id;   // 0xFF = alle CPUs
+    uint16_t flags;
+    uint8_t lint;
+} __attribute__((packed));
+
+struct madt_lapic_override {
+    struct madt_entry header;
+    uint16_t reserved;
+    uint64_t address;
+} __attribute__((packed));
+
+// ACPI MCFG (PCIe ECAM-Bereiche, Signatur "MCFG")
+struct acpi_mcfg_entry {
+    uint64_t base;          // ECAM-Basis für start_bus
+    uint16_t segment;
+    uint8_t start_bus;
+    uint8_t end_bus;
+    uint32_t reserved;
+} __attribute__((packed));
+
+struct acpi_mcfg {
+    struct acpi_sdt_header header;
+    uint64_t reserved;
+    struct acpi_mcfg_entry entries[];
+} __attribute__((packed));
+
+// ECAM von Segment 0 (nur unterhalb 4 GB nutzbar), für pci.c
+struct acpi_ecam_info {
+    int present;
+    uint32_t base;          // Adresse von Bus start_bus
+    uint8_t start_bus;
+    uint8_t end_bus;
+};
+
+extern struct acpi_ecam_info acpi_ecam;
+
+// MPS INTI Flags (ISO, NMI)
+#define MPS_POLARITY_MASK       0x03
+#define MPS_POLARITY_LOW        0x03
+#define MPS_TRIGGER_MASK        0x0C
+#define MPS_TRIGGER_LEVEL       0x0C
+
+// Ausgewertete MADT für apic.c
+#define ACPI_MAX_CPUS           16
+#define ACPI_MAX_IOAPICS        4
+
+struct acpi_ioapic_info {
+    uint8_t id;
+    uint32_t address;
+    uint32_t gsi_base;
+};
+
+struct acpi_madt_info {
+    int present;
+    uint32_t lapic_address;
+    int pcat_compat;
+    int cpu_count;
+    uint8_t cpu_apic_id[ACPI_MAX_CPUS];
+    int ioapic_count;
+    struct acpi_ioapic_info ioapic[ACPI_MAX_IOAPICS];
+    uint32_t isa_gsi[16];           // ISA-IRQ -> GSI (ohne Override identisch)
+    uint16_t isa_flags[16];         // MPS INTI Flags, 0 = ISA-Standard (Flanke, high)
+    int nmi_lint;                   // LINT-Pin für NMI, -1 = keiner
+};
+
+extern struct acpi_madt_info acpi_madt_info;
+
 // Funktionen
 void acpi_init(void);
+
+// Tabelle über die RSDT suchen und einblenden, NULL wenn nicht vorhanden
+struct acpi_sdt_header* acpi_find_table(const char* signature);
 void acpi_reboot(void);
 void acpi_shutdown(void);
 int acpi_is_available(void);
@@ -1,33 +1,720 @@
+// kernel/drivers/ahci.c - AHCI SATA: DMA-Transfers, NCQ, Abschluss per Interrupt
 #include "ahci.h"
 #include "pci.h"
+#include "apic.h"
 #include "screen.h"
 #include "../lib/utils.h"
+#include "../lib/mem.h"
+#include "../lib/printf.h"
+#include "../memory/paging.h"
+#include "../memory/buddy.h"
+#include "../memory/heap.h"
+#include "../memory/idt.h"
+#include "../cpu/cpu.h"
+#include "../cpu/work.h"
+#include "../lib/bitmap.h"
+#include "../lib/log.h"
+
+static volatile struct ahci_hba* hba = 0;
+static struct pci_device* ahci_dev = 0;
+static struct ahci_drive drives[AHCI_MAX_PORTS];
+static int drive_count = 0;
+static uint32_t slot_count = 1;
+
+static struct work recover_work;
+
+// Abschluss: 0 = Polling, sonst kommt er per (MSI-)Interrupt
+static int irq_mode = 0;
+static uint32_t irq_count = 0;
+
+#define AHCI_TIMEOUT_MS      5000
+#define AHCI_TABLES_ORDER    3          // 32 Tabellen à 1 KB = 8 Seiten
+
+// ========================
+// ZEIT
+// ========================
+static uint64_t deadline_after(uint32_t ms) {
+    uint32_t khz = cpu.tsc_khz ? cpu.tsc_khz : 1000000;    // unkalibriert: 1 GHz annehmen
+    return rdtsc() + (uint64_t)khz * ms;
+}
+
+static int expired(uint64_t deadline) {
+    return (int64_t)(rdtsc() - deadline) > 0;
+}
+
+// Bis (*reg & mask) == 0 oder Timeout
+static int wait_clear(volatile uint32_t* reg, uint32_t mask, uint32_t ms) {
+    uint64_t deadline = deadline_after(ms);
+    while (*reg & mask) {
+        if (expired(deadline)) return -1;
+        asm volatile("pause");
+    }
+    return 0;
+}
+
+// ========================
+// SLOTS
+// ========================
+// Ohne NCQ ist slot_mask = 1: ein Befehl pro Port, wie bisher
+static int slot_alloc(struct ahci_drive* d) {
+    uint32_t flags = irq_save();
+    uint32_t free = d->slot_mask & ~d->busy;
+    if (!free) {
+        irq_restore(flags);
+        return -1;
+    }
+    int slot = bit_scan_forward(free);
+    d->busy |= 1u << slot;
+    irq_restore(flags);
+    return slot;
+}
+
+static void slot_free(struct ahci_drive* d, int slot) {
+    uint32_t flags = irq_save();
+    d->busy &= ~(1u << slot);
+    irq_restore(flags);
+}
+
+// ========================
+// ABSCHLUSS (IRQ + Polling)
+// ========================
+// Synchrone Aufrufer holen das Ergebnis über done/failed ab, asynchrone
+// bekommen ihren Callback - der Slot ist dann schon frei und darf neu belegt werden.
+static void finish_slot(struct ahci_drive* d, int slot, int status) {
+    struct ahci_request* r = &d->requests[slot];
+    uint32_t bit = 1u << slot;
+
+    if (status == 0 && r->bytes) {
+        if (r->write) d->writes++;
+        else d->reads++;
+        d->bytes += r->bytes;
+    }
+
+    if (!r->callback) {
+        d->done |= bit;
+        if (status) d->failed |= bit;
+        return;
+    }
+
+    ahci_callback_t callback = r->callback;
+    r->callback = 0;
+    d->busy &= ~bit;
+    callback(status, r->ctx);
+}
+
+// Nach einem Fehler bricht das Gerät alle offenen (NCQ-)Befehle ab: alle
+// scheitern lassen, den Neustart erledigt port_recover außerhalb des IRQs.
+static void fail_active(struct ahci_drive* d) {
+    uint32_t active = d->active;
+    d->active = 0;
+    d->errors++;
+    if (!d->recover) {
+        d->recover = 1;
+        schedule_work(&recover_work);
+    }
+
+    while (active) {
+        int slot = bit_scan_forward(active);
+        active &= active - 1;
+        finish_slot(d, slot, -1);
+    }
+}
+
+// Port-IS quittieren und fertige Slots abschließen. Mit NCQ löscht das Gerät
+// SACT per Set-Device-Bits-FIS, ohne NCQ löscht der HBA CI.
+static void port_complete(struct ahci_drive* d) {
+    volatile struct ahci_port* p = d->regs;
+    uint32_t is = p->is;
+    p->is = is;
+
+    uint32_t active = d->active;
+    if (!active) return;
+
+    // Auch beim Fehler: was SACT/CI schon verlassen hat, ist erfolgreich fertig.
+    // Scheitern lassen nur die Befehle, die noch offen sind. recover vorher
+    // setzen, damit Callbacks nichts in den gestörten Port nachreichen.
+    int error = (is & AHCI_PORT_IS_ERROR) != 0;
+    if (error && !d->recover) {
+        d->recover = 1;
+        schedule_work(&recover_work);
+    }
+
+    uint32_t finished = active & ~(p->sact | p->ci);
+    d->active = active & ~finished;
+    while (finished) {
+        int slot = bit_scan_forward(finished);
+        finished &= finished - 1;
+        finish_slot(d, slot, 0);
+    }
+
+    if (error) fail_active(d);
+}
+
+static int ahci_irq(void* ctx) {
+    uint32_t pending = hba->is;
+    if (!pending) return IRQ_NONE;
+
+    irq_count++;
+    for (int port = 0; port < AHCI_MAX_PORTS; port++) {
+        if (!(pending & (1u << port))) continue;
+        if (drives[port].present) port_complete(&drives[port]);
+        else hba->ports[port].is = hba->ports[port].is;
+    }
+
+    // Erst die Port-Bits, dann das globale Bit löschen
+    hba->is = pending;
+    return IRQ_HANDLED;
+}
+
+static inline int interrupts_enabled(void) {
+    uint32_t flags;
+    asm volatile("pushfl\n popl %0" : "=r"(flags));
+    return flags & 0x200;
+}
+
+// Wartebedingungen, laufen mit gesperrten Interrupts
+static int slot_done(struct ahci_drive* d, uint32_t slot) {
+    return (d->done & (1u << slot)) != 0;
+}
+
+static int port_idle(struct ahci_drive* d, uint32_t unused) {
+    return d->active == 0;
+}
+
+static int busy_at_most(struct ahci_drive* d, uint32_t count) {
+    uint32_t busy = d->busy;
+    return bitmap_count_set(&busy, AHCI_MAX_SLOTS) <= count;
+}
+
+// Bis cond erfüllt ist: mit IRQ schlafen (cli/Prüfen/sti;hlt), sonst pollen.
+// Beim Timeout scheitern alle offenen Befehle.
+static int wait_until(struct ahci_drive* d, int (*cond)(struct ahci_drive*, uint32_t), uint32_t arg) {
+    uint64_t deadline = deadline_after(AHCI_TIMEOUT_MS);
+    int sleep = irq_mode && interrupts_enabled();
+
+    while (1) {
+        uint32_t flags = irq_save();
+        if (!sleep) port_complete(d);
+        if (cond(d, arg)) {
+            irq_restore(flags);
+            return 0;
+        }
+        if (expired(deadline)) {
+            klog(LOG_ERROR, "AHCI: port %d timed out, slots %08X", d->port, d->active);
+            fail_active(d);
+            irq_restore(flags);
+            return -1;
+        }
+        if (sleep) asm volatile("sti; hlt" ::: "memory");
+        else irq_restore(flags);
+    }
+}
+
+// Synchronen Befehl abwarten, Ergebnis abholen und den Slot freigeben
+static int wait_slot(struct ahci_drive* d, int slot) {
+    uint32_t bit = 1u << slot;
+    int result = wait_until(d, slot_done, slot);
+
+    uint32_t flags = irq_save();
+    if (d->failed & bit) result = -1;
+    d->done &= ~bit;
+    d->failed &= ~bit;
+    d->busy &= ~bit;
+    irq_restore(flags);
+    return result;
+}
+
+// ========================
+// PORT-STEUERUNG
+// ========================
+static int port_stop(volatile struct ahci_port* p) {
+    p->cmd &= ~AHCI_PORT_CMD_ST;
+    if (wait_clear(&p->cmd, AHCI_PORT_CMD_CR, 500) < 0) return -1;
+    p->cmd &= ~AHCI_PORT_CMD_FRE;
+    return wait_clear(&p->cmd, AHCI_PORT_CMD_FR, 500);
+}
+
+static int port_start(volatile struct ahci_port* p) {
+    if (wait_clear(&p->tfd, AHCI_TFD_BSY | AHCI_TFD_DRQ, 1000) < 0) return -1;
+    p->cmd |= AHCI_PORT_CMD_FRE;
+    p->cmd |= AHCI_PORT_CMD_ST;
+    return 0;
+}
+
+// ========================
+// BEFEHLE
+// ========================
+// PRDT aus dem Puffer bauen: physisch zusammenhängende Seiten werden zu einem
+// Eintrag (max. 4 MB). Rückgabe: abgedeckte Bytes (ganze Sektoren), Einträge in *entries.
+static uint32_t build_prdt(struct ahci_cmd_table* t, uint8_t* buf, uint32_t bytes, int* entries) {
+    int n = 0;
+    uint32_t done = 0;
+    uint32_t next_phys = 0;
+
+    while (done < bytes) {
+        uint32_t virt = (uint32_t)buf + done;
+        uint32_t phys = virt_to_phys(virt);
+        if (phys == PAGING_NO_MAPPING) break;
+
+        uint32_t chunk = PAGE_SIZE - (virt & (PAGE_SIZE - 1));
+        if (chunk > bytes - done) chunk = bytes - done;
+
+        uint32_t len = n ? (t->prdt[n - 1].dbc & 0x3FFFFF) + 1 : 0;
+        if (n && phys == next_phys && len + chunk <= AHCI_PRD_MAX_BYTES) {
+            t->prdt[n - 1].dbc = len + chunk - 1;
+        } else {
+            if (n == AHCI_PRDT_MAX) break;
+            t->prdt[n].dba = phys;
+            t->prdt[n].dbau = 0;
+            t->prdt[n].reserved = 0;
+            t->prdt[n].dbc = chunk - 1;
+            n++;
+        }
+        next_phys = phys + chunk;
+        done += chunk;
+    }
+
+    // Auf ganze Sektoren kürzen - der Rest kommt mit dem nächsten Befehl
+    uint32_t excess = done % AHCI_SECTOR_SIZE;
+    while (excess && n) {
+        uint32_t len = (t->prdt[n - 1].dbc & 0x3FFFFF) + 1;
+        if (len > excess) {
+            t->prdt[n - 1].dbc = len - excess - 1;
+            done -= excess;
+            excess = 0;
+        } else {
+            done -= len;
+            excess -= len;
+            n--;
+        }
+    }
+
+    if (n) t->prdt[n - 1].dbc |= AHCI_PRD_IRQ;
+    *entries = n;
+    return done;
+}
+
+static struct fis_reg_h2d* setup_fis(struct ahci_cmd_table* t, uint8_t command, uint64_t lba,
+                                     uint16_t count) {
+    struct fis_reg_h2d* fis = (struct fis_reg_h2d*)t->cfis;
+    memset(fis, 0, sizeof(*fis));
+
+    fis->type = FIS_TYPE_REG_H2D;
+    fis->flags = FIS_H2D_COMMAND;
+    fis->command = command;
+    fis->device = ATA_DEVICE_LBA;
+    fis->lba0 = lba;
+    fis->lba1 = lba >> 8;
+    fis->lba2 = lba >> 16;
+    fis->lba3 = lba >> 24;
+    fis->lba4 = lba >> 32;
+    fis->lba5 = lba >> 40;
+    fis->count_low = count;
+    fis->count_high = count >> 8;
+    return fis;
+}
+
+// Lese-/Schreibbefehl in die Tabelle des Slots. Mit NCQ steht die Sektorzahl
+// im Feature-Register und der Tag (= Slot) in Count Bits 7:3.
+// Rückgabe: abgedeckte Bytes, 0 wenn der Puffer nicht gemappt ist.
+static uint32_t prepare_rw(struct ahci_drive* d, int slot, uint64_t lba, uint32_t sectors,
+                           uint8_t* buf, int write, int* entries) {
+    struct ahci_cmd_table* t = &d->tables[slot];
+    uint32_t bytes = build_prdt(t, buf, sectors * AHCI_SECTOR_SIZE, entries);
+    sectors = bytes / AHCI_SECTOR_SIZE;
+    if (!sectors) return 0;
+
+    if (d->ncq) {
+        struct fis_reg_h2d* fis = setup_fis(t, write ? ATA_CMD_WRITE_FPDMA : ATA_CMD_READ_FPDMA,
+                                            lba, slot << 3);
+        fis->feature_low = sectors;
+        fis->feature_high = sectors >> 8;
+    } else {
+        setup_fis(t, write ? ATA_CMD_WRITE_DMA_EXT : ATA_CMD_READ_DMA_EXT, lba, sectors);
+    }
+    return bytes;
+}
+
+// Slot starten (Tabelle ist gefüllt). NCQ-Befehle werden zuerst in SACT markiert.
+static void start_slot(struct ahci_drive* d, int slot, int prdt_entries, int write, int queued) {
+    struct ahci_cmd_header* h = &d->cmd_list[slot];
+    // Ohne C-Bit: CI fällt erst, wenn die Daten übertragen sind
+    h->flags = AHCI_CMD_CFL(sizeof(struct fis_reg_h2d) / 4) | (write ? AHCI_CMD_WRITE : 0);
+    h->prdtl = prdt_entries;
+    h->prdbc = 0;
+
+    uint32_t flags = irq_save();
+    d->active |= 1u << slot;
+    if (queued) d->regs->sact = 1u << slot;
+    d->regs->ci = 1u << slot;
+
+    uint32_t active = d->active;
+    uint32_t inflight = bitmap_count_set(&active, AHCI_MAX_SLOTS);
+    if (inflight > d->max_inflight) d->max_inflight = inflight;
+    irq_restore(flags);
+}
+
+// Nicht-NCQ-Befehl (IDENTIFY, FLUSH, READ LOG): darf nicht neben
+// NCQ-Befehlen laufen, deshalb erst die Queue leerlaufen lassen
+static int exec_command(struct ahci_drive* d, uint8_t command, uint64_t lba, uint16_t count,
+                        void* buf, uint32_t bytes) {
+    if (wait_until(d, port_idle, 0) < 0) return -1;
+
+    int slot = slot_alloc(d);
+    if (slot < 0) return -1;
+
+    int entries = 0;
+    struct ahci_cmd_table* t = &d->tables[slot];
+    if (bytes && build_prdt(t, (uint8_t*)buf, bytes, &entries) != bytes) {
+        slot_free(d, slot);
+        return -1;
+    }
+    setup_fis(t, command, lba, count);
+
+    d->requests[slot].callback = 0;
+    d->requests[slot].bytes = 0;
+    start_slot(d, slot, entries, 0, 0);
+    return wait_slot(d, slot);
+}
+
+// Nach einem Fehler: Port neu starten, Fehlerregister leeren. Mit NCQ bleibt
+// das Gerät im Fehlerzustand, bis das NCQ-Fehlerlog gelesen wurde.
+// recover: 1 = nötig, 2 = läuft (Fehler währenddessen lösen keinen neuen aus)
+static void port_recover(struct ahci_drive* d) {
+    uint32_t flags = irq_save();
+    if (d->recover != 1) {
+        irq_restore(flags);
+        return;
+    }
+    d->recover = 2;
+    irq_restore(flags);
+
+    volatile struct ahci_port* p = d->regs;
+    klog(LOG_ERROR, "AHCI: port %d error, TFD %08X SERR %08X", d->port, p->tfd, p->serr);
+
+    port_stop(p);
+    p->serr = 0xFFFFFFFF;
+    p->is = 0xFFFFFFFF;
+    port_start(p);
+
+    if (d->ncq) {
+        uint8_t* log = (uint8_t*)alloc_page();
+        if (log) {
+            if (exec_command(d, ATA_CMD_READ_LOG_EXT, ATA_LOG_NCQ_ERROR, 1, log,
+                             AHCI_SECTOR_SIZE) == 0) {
+                klog(LOG_ERROR, "AHCI: port %d NCQ error in tag %d", d->port, log[0] & 0x1F);
+            }
+            free_page(log);
+        }
+    }
+
+    d->recover = 0;
+}
+
+static void recover_work_fn(void* arg) {
+    for (int port = 0; port < AHCI_MAX_PORTS; port++) {
+        if (drives[port].present && drives[port].recover == 1) port_recover(&drives[port]);
+    }
+}
+
+int ahci_submit(int port, uint64_t lba, uint32_t count, void* buffer, int write,
+                ahci_callback_t callback, void* ctx) {
+    struct ahci_drive* d = ahci_get_drive(port);
+    if (!d || !callback || d->recover) return -1;
+    if (!count || count > AHCI_MAX_SECTORS || ((uint32_t)buffer & 1)) return -1;
+    if (lba + count > d->sectors) return -1;
+
+    int slot = slot_alloc(d);
+    if (slot < 0) return -1;
+
+    int entries;
+    uint32_t bytes = prepare_rw(d, slot, lba, count, (uint8_t*)buffer, write, &entries);
+    if (bytes != count * AHCI_SECTOR_SIZE) {
+        slot_free(d, slot);
+        return -1;
+    }
+
+    struct ahci_request* r = &d->requests[slot];
+    r->callback = callback;
+    r->ctx = ctx;
+    r->bytes = bytes;
+    r->write = write;
+    start_slot(d, slot, entries, write, d->ncq);
+    return slot;
+}
+
+int ahci_wait_queue(int port, int max_inflight) {
+    struct ahci_drive* d = ahci_get_drive(port);
+    if (!d || max_inflight < 0) return -1;
+    return wait_until(d, busy_at_most, max_inflight);
+}
+
+// Synchron: in Befehle zu max. AHCI_MAX_SECTORS zerlegen, jeden abwarten.
+// Läuft mit NCQ neben asynchronen Befehlen in einem freien Slot.
+static int ahci_rw(int port, uint64_t lba, uint32_t count, void* buffer, int write) {
+    struct ahci_drive* d = ahci_get_drive(port);
+    if (!d || ((uint32_t)buffer & 1)) return -1;
+    if (lba + count > d->sectors) return -1;
+
+    uint8_t* buf = (uint8_t*)buffer;
+
+    while (count) {
+        port_recover(d);
+        if (d->recover) return -1;
+
+        int slot;
+        while ((slot = slot_alloc(d)) < 0) {
+            if (wait_until(d, busy_at_most, d->queue_depth - 1) < 0) return -1;
+        }
+
+        uint32_t sectors = count > AHCI_MAX_SECTORS ? AHCI_MAX_SECTORS : count;
+        int entries;
+        uint32_t bytes = prepare_rw(d, slot, lba, sectors, buf, write, &entries);
+        if (!bytes) {
+            slot_free(d, slot);
+            return -1;
+        }
+
+        struct ahci_request* r = &d->requests[slot];
+        r->callback = 0;
+        r->bytes = bytes;
+        r->write = write;
+        start_slot(d, slot, entries, write, d->ncq);
+        if (wait_slot(d, slot) < 0) {
+            port_recover(d);
+            return -1;
+        }
+
+        sectors = bytes / AHCI_SECTOR_SIZE;
+        lba += sectors;
+        count -= sectors;
+        buf += bytes;
+    }
+    return 0;
+}
+
+int ahci_read_sectors(int port, uint64_t lba, uint32_t sector_count, void* buffer) {
+    return ahci_rw(port, lba, sector_count, buffer, 0);
+}
+
+int ahci_write_sectors(int port, uint64_t lba, uint32_t sector_count, void* buffer) {
+    return ahci_rw(port, lba, sector_count, buffer, 1);
+}
+
+int ahci_flush(int port) {
+    struct ahci_drive* d = ahci_get_drive(port);
+    if (!d) return -1;
+
+    port_recover(d);
+    if (exec_command(d, ATA_CMD_FLUSH_CACHE_EXT, 0, 0, 0, 0) < 0) {
+        port_recover(d);
+        return -1;
+    }
+    return 0;
+}
+
+struct ahci_drive* ahci_get_drive(int port) {
+    if (port < 0 || port >= AHCI_MAX_PORTS || !drives[port].present) return 0;
+    return &drives[port];
+}
+
+// ========================
+// INIT
+// ========================
+// IDENTIFY DEVICE: Größe (LBA48), Modellname und NCQ-Tiefe
+static int identify(struct ahci_drive* d) {
+    uint16_t* id = (uint16_t*)alloc_page();
+    if (!id) return -1;
+
+    d->queue_depth = 1;
+    d->slot_mask = 1;
+    if (exec_command(d, ATA_CMD_IDENTIFY, 0, 0, id, AHCI_SECTOR_SIZE) < 0) {
+        free_page(id);
+        return -1;
+    }
+
+    d->sectors = (uint64_t)id[100] | ((uint64_t)id[101] << 16) |
+                 ((uint64_t)id[102] << 32) | ((uint64_t)id[103] << 48);
+    if (!d->sectors) d->sectors = id[60] | ((uint32_t)id[61] << 16);     // nur LBA28
+
+    // Modell: Wörter 27-46, je zwei Zeichen vertauscht
+    for (int i = 0; i < 20; i++) {
+        d->model[i * 2] = id[27 + i] >> 8;
+        d->model[i * 2 + 1] = id[27 + i] & 0xFF;
+    }
+    d->model[40] = '\0';
+    for (int i = 39; i >= 0 && d->model[i] == ' '; i--) d->model[i] = '\0';
+
+    // NCQ: HBA (CAP.SNCQ) und Gerät (Wort 76 Bit 8) müssen es können, Tiefe in Wort 75
+    d->ncq = (hba->cap & AHCI_CAP_SNCQ) && (id[76] & (1 << 8));
+    if (d->ncq) {
+        d->queue_depth = (id[75] & 0x1F) + 1;
+        if (d->queue_depth > (int)slot_count) d->queue_depth = slot_count;
+        d->slot_mask = d->queue_depth == 32 ? 0xFFFFFFFF : (1u << d->queue_depth) - 1;
+    }
+
+    free_page(id);
+    return 0;
+}
+
+static int port_init(int port) {
+    volatile struct ahci_port* p = &hba->ports[port];
+
+    uint32_t ssts = p->ssts;
+    if (AHCI_SSTS_DET(ssts) != 3 || AHCI_SSTS_IPM(ssts) != 1) return 0;
+    if (p->sig != AHCI_PORT_SIG_ATA) return 0;      // ATAPI & Co. nicht unterstützt
+
+    struct ahci_drive* d = &drives[port];
+    memset(d, 0, sizeof(*d));
+    d->port = port;
+    d->regs = p;
+
+    if (port_stop(p) < 0) {
+        klog(LOG_WARN, "AHCI: port %d does not stop", port);
+        return 0;
+    }
+
+    // Command List (1 KB) + Received FIS (256 B) in einer Seite, Tabellen dahinter
+    uint8_t* page = (uint8_t*)alloc_page();
+    d->tables = (struct ahci_cmd_table*)alloc_pages(AHCI_TABLES_ORDER);
+    if (!page || !d->tables) {
+        klog(LOG_ERROR, "AHCI: port %d out of memory", port);
+        return 0;
+    }
+    memset(page, 0, PAGE_SIZE);
+    memset(d->tables, 0, PAGE_SIZE << AHCI_TABLES_ORDER);
+
+    d->cmd_list = (struct ahci_cmd_header*)page;
+    d->fis = page + 1024;
+    for (int slot = 0; slot < AHCI_MAX_SLOTS; slot++) {
+        d->cmd_list[slot].cmd_table = virt_to_phys((uint32_t)&d->tables[slot]);
+    }
+
+    p->clb = virt_to_phys((uint32_t)d->cmd_list);
+    p->clbu = 0;
+    p->fb = virt_to_phys((uint32_t)d->fis);
+    p->fbu = 0;
+    p->serr = 0xFFFFFFFF;
+    p->is = 0xFFFFFFFF;
+    p->ie = AHCI_PORT_IE_DEFAULT;
+
+    if (port_start(p) < 0) {
+        klog(LOG_WARN, "AHCI: port %d busy after reset", port);
+        return 0;
+    }
+
+    d->present = 1;
+    if (identify(d) < 0) {
+        d->present = 0;
+        klog(LOG_WARN, "AHCI: port %d IDENTIFY failed", port);
+        return 0;
+    }
+
+    klog(LOG_INFO, "AHCI: port %d %s, %u MB, %s", port, d->model, (uint32_t)(d->sectors >> 11),
+         d->ncq ? "NCQ" : "no NCQ");
+    return 1;
+}
+
+// Firmware die Kontrolle abnehmen (BIOS/OS Handoff), dann HBA-Reset
+static int hba_reset(void) {
+    if (hba->cap2 & AHCI_CAP2_BOH) {
+        hba->bohc |= AHCI_BOHC_OOS;
+        wait_clear(&hba->bohc, AHCI_BOHC_BOS, 2000);
+    }
+
+    hba->ghc |= AHCI_GHC_AE;
+    hba->ghc |= AHCI_GHC_HR;
+    if (wait_clear(&hba->ghc, AHCI_GHC_HR, 1000) < 0) return -1;
+    hba->ghc |= AHCI_GHC_AE;
+    return 0;
+}
+
+// Abschluss-Interrupt: MSI, ohne APIC die INTx-Leitung aus dem Konfigurationsraum.
+// Mit APIC und ohne MSI fehlt die _PRT-Zuordnung (AML) - dann wird gepollt.
+static void setup_irq(void) {
+    if (pci_enable_msi(ahci_dev, 1, ahci_irq, 0)) {
+        irq_mode = 1;
+    } else if (!apic_active() && ahci_dev->irq_line < 16) {
+        irq_register(IRQ_BASE + ahci_dev->irq_line, "ahci", ahci_irq, 0);
+        irq_unmask(ahci_dev->irq_line);
+        irq_mode = 1;
+    } else {
+        klog(LOG_WARN, "AHCI: no usable interrupt, polling for completion");
+        return;
+    }
+
+    hba->is = 0xFFFFFFFF;
+    hba->ghc |= AHCI_GHC_IE;
+}
 
 void ahci_init(void) {
-    kprint("\n=== AHCI Check ===\n", TXT_CYAN);
-    for (uint32_t slot = 0; slot < 32; slot++) {
-        uint32_t vendev = pci_config_read(0, slot, 0, 0);
-        if ((vendev & 0xFFFF) == 0xFFFF) continue;
-
-        uint32_t class = pci_config_read(0, slot, 0, 0x08);
-        uint8_t class_code = (class >> 24) & 0xFF;
-        uint8_t subclass  = (class >> 16) & 0xFF;
-        uint8_t prog_if    = (class >> 8) & 0xFF;
-
-        if (class_code == 0x01 && subclass == 0x06 && prog_if == 0x01) {
-            kprint("AHCI Controller found at slot ", TXT_SUCCESS);
-            char c = '0' + slot;
-            kprint(&c, TXT_YELLOW);
-            kprint("\n", TXT_NORMAL);
-
-            uint32_t bar5 = pci_config_read(0, slot, 0, 0x24);
-            kprint("ABAR: ", TXT_INFO);
-            char hex[16];
-            hex_to_string(bar5 & ~0xF, hex);
-            kprint(hex, TXT_INFO);
-            kprint("\n", TXT_NORMAL);
-            return;
-        }
-    }
-    kprint("No AHCI controller found.\n", TXT_ERROR);
+    ahci_dev = pci_find_class(PCI_CLASS_MASS_STORAGE, PCI_SUBCLASS_SATA, PCI_PROG_IF_AHCI, 0);
+    if (!ahci_dev || !pci_bar_address(ahci_dev, 5)) {
+        klog(LOG_WARN, "AHCI: no controller found");
+        return;
+    }
+
+    uint32_t abar = pci_bar_address(ahci_dev, 5);
+    klog(LOG_INFO, "AHCI: controller at %02X:%02X.%u, ABAR %08X", ahci_dev->bus,
+         ahci_dev->slot, ahci_dev->func, abar);
+
+    // Register-Bereich liegt oberhalb des RAM: uncached mappen
+    hba = (volatile struct ahci_hba*)map_mmio(abar, AHCI_ABAR_SIZE, MMIO_UNCACHED);
+
+    // Memory-Decoding + Bus Master (DMA)
+    uint16_t cmd = pci_read16(ahci_dev, PCI_COMMAND);
+    pci_write16(ahci_dev, PCI_COMMAND, cmd | PCI_COMMAND_MEMORY | PCI_COMMAND_MASTER);
+
+    if (hba_reset() < 0) {
+        klog(LOG_ERROR, "AHCI: HBA reset timed out");
+        hba = 0;
+        return;
+    }
+
+    slot_count = AHCI_CAP_NCS(hba->cap);
+    work_init(&recover_work, "ahci", ahci_dev->irq_line, recover_work_fn, 0);
+    uint32_t implemented = hba->pi;
+
+    // Ports werden vor sti gepollt, danach übernimmt der Interrupt
+    for (int port = 0; port < AHCI_MAX_PORTS; port++) {
+        if (implemented & (1u << port)) drive_count += port_init(port);
+    }
+
+    setup_irq();
+    klog(LOG_INFO, "AHCI: %d drive(s), %u slots, %s", drive_count, slot_count,
+         irq_mode ? "interrupt completion" : "polled completion");
+}
+
+void ahci_print_info(void) {
+    if (!hba) {
+        kprint("AHCI: no controller\n", TXT_GRAY);
+        return;
+    }
+
+    const char* mode = !irq_mode ? "polled" :
+                       ahci_dev->irq_mode == PCI_IRQ_MSIX ? "MSI-X" :
+                       ahci_dev->irq_mode == PCI_IRQ_MSI ? "MSI" : "INTx";
+    kprintf(TXT_NORMAL, "AHCI %02X:%02X.%u  %u slots, completion: %C%s%C, %u irqs\n",
+            ahci_dev->bus, ahci_dev->slot, ahci_dev->func, slot_count,
+            TXT_CYAN, mode, TXT_NORMAL, irq_count);
+
+    if (!drive_count) {
+        kprint("  no SATA drives\n", TXT_GRAY);
+        return;
+    }
+
+    for (int port = 0; port < AHCI_MAX_PORTS; port++) {
+        struct ahci_drive* d = ahci_get_drive(port);
+        if (!d) continue;
+        kprintf(TXT_NORMAL, "  port %d: %C%s%C, %u MB\n", port, TXT_INFO, d->model,
+                TXT_NORMAL, (uint32_t)(d->sectors >> 11));
+        if (d->ncq) {
+            kprintf(TXT_GRAY, "          NCQ depth %d, max %u in flight\n", d->queue_depth,
+                    d->max_inflight);
+        } else {
+            kprint("          no NCQ, one command at a time\n", TXT_GRAY);
+        }
+        kprintf(TXT_GRAY, "          %u reads, %u writes, %u KB, %u errors\n",
+                d->reads, d->writes, (uint32_t)(d->bytes >> 10), d->errors);
+    }
 }
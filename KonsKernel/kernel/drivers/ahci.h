@@ -16,9 +16,26 @@
 #define AHCI_VERSION         0x10
 #define AHCI_PORT_BASE       0x100
 #define AHCI_PORT_SIZE       0x80
+#define AHCI_ABAR_SIZE       0x1100     // Generic Host Control + 32 Ports
+
+#define AHCI_MAX_PORTS       32
+#define AHCI_MAX_SLOTS       32
+#define AHCI_PRDT_MAX        56         // Command Table = 1 KB
+#define AHCI_PRD_MAX_BYTES   0x400000   // 4 MB pro PRDT-Eintrag
+#define AHCI_MAX_SECTORS     0xFFFF     // pro READ/WRITE DMA EXT
+#define AHCI_SECTOR_SIZE     512
+
+// Host Capabilities
+#define AHCI_CAP_NCS(cap)    ((((cap) >> 8) & 0x1F) + 1)   // Command Slots
+#define AHCI_CAP_SNCQ        (1 << 30)
+#define AHCI_CAP_S64A        (1u << 31)
+#define AHCI_CAP2_BOH        (1 << 0)   // BIOS/OS Handoff
+#define AHCI_BOHC_BOS        (1 << 0)   // BIOS Owned Semaphore
+#define AHCI_BOHC_OOS        (1 << 1)   // OS Owned Semaphore
 
 // Global Host Control
-#define AHCI_GHC_AE          (1 << 31)  // AHCI Enable
+#define AHCI_GHC_AE          (1u << 31) // AHCI Enable
+#define AHCI_GHC_IE          (1 << 1)   // Interrupt Enable
 #define AHCI_GHC_HR          (1 << 0)   // HBA Reset
 
 // Port Command and Status
@@ -31,12 +48,68 @@
 #define AHCI_PORT_IS_DHRS    (1 << 0)   // Device to Host FIS
 #define AHCI_PORT_IS_PSS     (1 << 1)   // PIO Setup FIS
 #define AHCI_PORT_IS_DPS     (1 << 5)   // DMA Setup FIS
+#define AHCI_PORT_IS_SDBS    (1 << 3)   // Set Device Bits FIS
 #define AHCI_PORT_IS_PRCS    (1 << 22)  // PhyRdy Change
+#define AHCI_PORT_IS_IFS     (1 << 27)  // Interface Fatal Error
+#define AHCI_PORT_IS_HBDS    (1 << 28)  // Host Bus Data Error
+#define AHCI_PORT_IS_HBFS    (1 << 29)  // Host Bus Fatal Error
+#define AHCI_PORT_IS_TFES    (1 << 30)  // Task File Error
+#define AHCI_PORT_IS_ERROR   (AHCI_PORT_IS_IFS | AHCI_PORT_IS_HBDS | AHCI_PORT_IS_HBFS | \
+                              AHCI_PORT_IS_TFES)
+
+// Port Interrupt Enable: Abschluss + Fehler
+#define AHCI_PORT_IE_DEFAULT (AHCI_PORT_IS_DHRS | AHCI_PORT_IS_PSS | AHCI_PORT_IS_DPS | \
+                              AHCI_PORT_IS_SDBS | AHCI_PORT_IS_ERROR)
+
+// Task File Data / SATA Status
+#define AHCI_TFD_ERR         0x01
+#define AHCI_TFD_DRQ         0x08
+#define AHCI_TFD_BSY         0x80
+#define AHCI_SSTS_DET(s)     ((s) & 0x0F)          // 3 = Gerät da, Phy steht
+#define AHCI_SSTS_IPM(s)     (((s) >> 8) & 0x0F)   // 1 = aktiv
 
 // Port Signature
 #define AHCI_PORT_SIG_ATA    0x00000101  // SATA Drive
 #define AHCI_PORT_SIG_ATAPI  0xEB140101  // ATAPI Drive
 
+// ATA Befehle
+#define ATA_CMD_READ_DMA_EXT     0x25
+#define ATA_CMD_WRITE_DMA_EXT    0x35
+#define ATA_CMD_FLUSH_CACHE_EXT  0xEA
+#define ATA_CMD_IDENTIFY         0xEC
+#define ATA_CMD_READ_LOG_EXT     0x2F
+#define ATA_CMD_READ_FPDMA       0x60   // NCQ: Sektorzahl in Feature, Tag in Count
+#define ATA_CMD_WRITE_FPDMA      0x61
+#define ATA_DEVICE_LBA           0x40
+#define ATA_LOG_NCQ_ERROR        0x10   // liest den Fehlerzustand nach NCQ-Fehler aus
+
+// Register FIS Host -> Device
+#define FIS_TYPE_REG_H2D     0x27
+#define FIS_H2D_COMMAND      0x80       // C-Bit: Befehl, nicht Control
+
+struct fis_reg_h2d {
+    uint8_t type;
+    uint8_t flags;
+    uint8_t command;
+    uint8_t feature_low;
+    uint8_t lba0, lba1, lba2;
+    uint8_t device;
+    uint8_t lba3, lba4, lba5;
+    uint8_t feature_high;
+    uint8_t count_low;
+    uint8_t count_high;
+    uint8_t icc;
+    uint8_t control;
+    uint8_t reserved[4];
+} __attribute__((packed));
+
+// Command Header flags
+#define AHCI_CMD_CFL(dwords) ((dwords) & 0x1F)
+#define AHCI_CMD_WRITE       (1 << 6)
+#define AHCI_CMD_PREFETCH    (1 << 7)
+#define AHCI_CMD_CLEAR_BUSY  (1 << 10)   // nur Soft Reset/BIST: CI fällt schon nach dem FIS
+#define AHCI_PRD_IRQ         (1u << 31) // Interrupt nach diesem Eintrag
+
 // Command List Entry
 struct ahci_cmd_header {
     uint16_t flags;
@@ -56,7 +129,7 @@ struct ahci_cmd_table {
         uint32_t dbau;   // Data Base Address Upper
         uint32_t reserved;
         uint32_t dbc;    // Data Byte Count
-    } prdt[1];           // Physical Region Descriptor Table
+    } prdt[AHCI_PRDT_MAX];  // Physical Region Descriptor Table (Scatter-Gather)
 } __attribute__((packed));
 
 // Port Register Set
@@ -100,10 +173,72 @@ struct ahci_hba {
     struct ahci_port ports[32];
 } __attribute__((packed));
 
+// Abschluss eines asynchronen Befehls: status 0 = ok, -1 = Fehler.
+// Läuft im IRQ-Kontext (oder beim Pollen), der Slot ist dann schon wieder frei.
+typedef void (*ahci_callback_t)(int status, void* ctx);
+
+struct ahci_request {
+    ahci_callback_t callback;   // 0 = synchroner Aufrufer wartet selbst
+    void* ctx;
+    uint32_t bytes;
+    uint8_t write;
+};
+
+// Ein angeschlossenes SATA-Laufwerk
+struct ahci_drive {
+    int present;
+    int port;
+    volatile struct ahci_port* regs;
+    struct ahci_cmd_header* cmd_list;   // 1 KB, 32 Slots
+    uint8_t* fis;                       // 256 Byte Received FIS
+    struct ahci_cmd_table* tables;      // eine Tabelle pro Slot
+
+    // Slots (Bit = Slot): slot_mask = nutzbare Tiefe, busy = vergeben
+    int ncq;
+    int queue_depth;
+    uint32_t slot_mask;
+    volatile uint32_t busy;
+    struct ahci_request requests[AHCI_MAX_SLOTS];
+
+    // Vom IRQ-Handler gepflegt (Bit = Slot)
+    volatile uint32_t active;
+    volatile uint32_t done;
+    volatile uint32_t failed;
+    volatile int recover;               // Fehler: Port muss neu gestartet werden
+
+    uint64_t sectors;
+    char model[41];
+
+    // Statistik
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t errors;
+    uint32_t max_inflight;
+    uint64_t bytes;
+};
+
 // Funktionen
+// Controller aus der PCI-Tabelle: HBA-Reset, Ports aufsetzen, IDENTIFY, IRQ (MSI oder INTx)
 void ahci_init(void);
-void ahci_scan_pci(void);
+
+// Laufwerk am Port, NULL wenn keins
+struct ahci_drive* ahci_get_drive(int port);
+
+// DMA-Transfer, buffer mindestens 2-Byte ausgerichtet. Rückgabe 0 = ok, -1 = Fehler.
+// Große Transfers werden in mehrere Befehle zerlegt, jeder mit Scatter-Gather-PRDT.
 int ahci_read_sectors(int port, uint64_t lba, uint32_t sector_count, void* buffer);
 int ahci_write_sectors(int port, uint64_t lba, uint32_t sector_count, void* buffer);
+int ahci_flush(int port);
+
+// Asynchron: ein Befehl (max. AHCI_MAX_SECTORS, Puffer muss in eine PRDT passen),
+// mit NCQ bis zu queue_depth gleichzeitig. Rückgabe Slot oder -1 (Queue voll/Fehler).
+int ahci_submit(int port, uint64_t lba, uint32_t sector_count, void* buffer, int write,
+                ahci_callback_t callback, void* ctx);
+
+// Warten, bis höchstens max_inflight Befehle offen sind (0 = Queue leer).
+// Ohne IRQ werden hier auch die Abschlüsse abgeholt.
+int ahci_wait_queue(int port, int max_inflight);
+
+void ahci_print_info(void);
 
 #endif
@@ -0,0 +1,228 @@
+// kernel/drivers/apic.c - Local APIC + IO APIC statt 8259
+#include "apic.h"
+#include "acpi.h"
+#include "pic.h"
+#include "screen.h"
+#include "../cpu/cpu.h"
+#include "../memory/paging.h"
+#include "../memory/idt.h"
+#include "../lib/utils.h"
+#include "../lib/printf.h"
+#include "../lib/log.h"
+
+struct ioapic {
+    volatile uint32_t* base;
+    uint8_t id;
+    uint32_t gsi_base;
+    uint32_t entries;
+};
+
+static volatile uint32_t* lapic = 0;
+static uint32_t lapic_phys = 0;
+static int active = 0;
+
+static struct ioapic ioapics[ACPI_MAX_IOAPICS];
+static int ioapic_count = 0;
+static uint16_t isa_routed = 0;      // Bit n = ISA-IRQ n hat einen IOAPIC-Eintrag
+
+// ========================
+// LOCAL APIC
+// ========================
+static inline uint32_t lapic_read(uint32_t reg) {
+    return lapic[reg / 4];
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t value) {
+    lapic[reg / 4] = value;
+}
+
+void lapic_eoi(void) {
+    lapic_write(LAPIC_EOI, 0);
+}
+
+uint8_t lapic_id(void) {
+    return lapic ? lapic_read(LAPIC_ID) >> 24 : 0;
+}
+
+uint32_t lapic_address(void) {
+    return lapic_phys;
+}
+
+int apic_active(void) {
+    return active;
+}
+
+static void lapic_init(uint32_t phys) {
+    // Basis aus der MADT übernehmen und global einschalten
+    uint64_t base = rdmsr(MSR_APIC_BASE);
+    if (!phys) phys = (uint32_t)base & PAGE_FRAME;
+    wrmsr(MSR_APIC_BASE, (base & 0xFFF) | (phys & PAGE_FRAME) | APIC_BASE_ENABLE);
+
+    lapic_phys = phys;
+    lapic = (volatile uint32_t*)map_mmio(phys, 0x1000, MMIO_UNCACHED);
+
+    // Alle Prioritäten annehmen, Timer aus, LINT0 (ExtINT vom PIC) aus
+    lapic_write(LAPIC_TPR, 0);
+    lapic_write(LAPIC_LVT_TIMER, LVT_MASKED);
+    lapic_write(LAPIC_LVT_LINT0, LVT_MASKED);
+    lapic_write(LAPIC_LVT_LINT1, LVT_MASKED);
+    if (acpi_madt_info.nmi_lint == 0) lapic_write(LAPIC_LVT_LINT0, LVT_NMI);
+    else lapic_write(LAPIC_LVT_LINT1, LVT_NMI);
+    lapic_write(LAPIC_LVT_ERROR, LVT_MASKED);
+
+    // ESR zweimal: der erste Schreibzugriff übernimmt, der zweite löscht
+    lapic_write(LAPIC_ESR, 0);
+    lapic_write(LAPIC_ESR, 0);
+
+    lapic_write(LAPIC_SVR, LAPIC_SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+    lapic_eoi();
+}
+
+// ========================
+// IO APIC
+// ========================
+static uint32_t ioapic_read(struct ioapic* io, uint8_t reg) {
+    io->base[IOAPIC_REGSEL / 4] = reg;
+    return io->base[IOAPIC_WINDOW / 4];
+}
+
+static void ioapic_write(struct ioapic* io, uint8_t reg, uint32_t value) {
+    io->base[IOAPIC_REGSEL / 4] = reg;
+    io->base[IOAPIC_WINDOW / 4] = value;
+}
+
+static struct ioapic* ioapic_for(uint32_t gsi) {
+    for (int i = 0; i < ioapic_count; i++) {
+        if (gsi >= ioapics[i].gsi_base && gsi < ioapics[i].gsi_base + ioapics[i].entries) {
+            return &ioapics[i];
+        }
+    }
+    return 0;
+}
+
+int ioapic_route(uint32_t gsi, uint8_t vector, uint8_t dest, uint16_t flags) {
+    struct ioapic* io = ioapic_for(gsi);
+    if (!io) return 0;
+
+    uint32_t low = vector | IOAPIC_MASKED;    // Fixed Delivery, physisches Ziel
+    if ((flags & MPS_POLARITY_MASK) == MPS_POLARITY_LOW) low |= IOAPIC_ACTIVE_LOW;
+    if ((flags & MPS_TRIGGER_MASK) == MPS_TRIGGER_LEVEL) low |= IOAPIC_LEVEL;
+
+    uint8_t reg = IOAPIC_REG_REDTBL + 2 * (gsi - io->gsi_base);
+    ioapic_write(io, reg, IOAPIC_MASKED);
+    ioapic_write(io, reg + 1, (uint32_t)dest << 24);
+    ioapic_write(io, reg, low);
+    return 1;
+}
+
+static void ioapic_set_mask(uint32_t gsi, int masked) {
+    struct ioapic* io = ioapic_for(gsi);
+    if (!io) return;
+
+    uint8_t reg = IOAPIC_REG_REDTBL + 2 * (gsi - io->gsi_base);
+    uint32_t flags = irq_save();
+    uint32_t low = ioapic_read(io, reg);
+    ioapic_write(io, reg, masked ? (low | IOAPIC_MASKED) : (low & ~IOAPIC_MASKED));
+    irq_restore(flags);
+}
+
+void ioapic_mask(uint32_t gsi) {
+    ioapic_set_mask(gsi, 1);
+}
+
+void ioapic_unmask(uint32_t gsi) {
+    ioapic_set_mask(gsi, 0);
+}
+
+// ========================
+// ISA-IRQs
+// ========================
+void apic_irq_mask(uint8_t irq) {
+    if (irq < 16 && (isa_routed & (1 << irq))) ioapic_mask(acpi_madt_info.isa_gsi[irq]);
+}
+
+void apic_irq_unmask(uint8_t irq) {
+    if (irq < 16 && (isa_routed & (1 << irq))) ioapic_unmask(acpi_madt_info.isa_gsi[irq]);
+}
+
+// Ziel-CPU ändern, Maskenzustand bleibt erhalten
+int apic_irq_affinity(uint8_t irq, uint8_t dest) {
+    if (irq >= 16 || !(isa_routed & (1 << irq))) return 0;
+    uint32_t gsi = acpi_madt_info.isa_gsi[irq];
+    struct ioapic* io = ioapic_for(gsi);
+    if (!io) return 0;
+
+    uint8_t reg = IOAPIC_REG_REDTBL + 2 * (gsi - io->gsi_base) + 1;
+    uint32_t flags = irq_save();
+    ioapic_write(io, reg, (uint32_t)dest << 24);
+    irq_restore(flags);
+    return 1;
+}
+
+// ========================
+// INIT
+// ========================
+int apic_init(void) {
+    struct acpi_madt_info* madt = &acpi_madt_info;
+    if (!cpu.apic || !cpu.msr || !madt->present || madt->ioapic_count == 0) {
+        klog(LOG_INFO, "APIC: not available, using 8259 PIC");
+        return 0;
+    }
+
+    lapic_init(madt->lapic_address);
+
+    for (int i = 0; i < madt->ioapic_count; i++) {
+        struct ioapic* io = &ioapics[ioapic_count++];
+        io->base = (volatile uint32_t*)map_mmio(madt->ioapic[i].address, 0x1000, MMIO_UNCACHED);
+        io->id = madt->ioapic[i].id;
+        io->gsi_base = madt->ioapic[i].gsi_base;
+        io->entries = ((ioapic_read(io, IOAPIC_REG_VERSION) >> 16) & 0xFF) + 1;
+
+        for (uint32_t e = 0; e < io->entries; e++) {
+            ioapic_write(io, IOAPIC_REG_REDTBL + 2 * e, IOAPIC_MASKED);
+        }
+    }
+
+    // ISA-IRQs auf dieselben Vektoren wie beim PIC, maskiert bis zum Treiber.
+    // IRQ 2 ist die Kaskade; eine GSI, die per Override schon einer anderen
+    // Quelle gehört (QEMU: IRQ 0 -> GSI 2), bekommt kein 1:1-Mapping.
+    uint8_t bsp = lapic_id();
+    for (int irq = 0; irq < 16; irq++) {
+        if (irq == 2) continue;
+        int claimed = 0;
+        for (int other = 0; other < 16; other++) {
+            if (other != irq && madt->isa_gsi[other] == madt->isa_gsi[irq] &&
+                madt->isa_gsi[other] != (uint32_t)other) claimed = 1;
+        }
+        if (claimed) continue;
+
+        ioapic_route(madt->isa_gsi[irq], IRQ_BASE + irq, bsp, madt->isa_flags[irq]);
+        isa_routed |= 1 << irq;
+    }
+
+    // 8259 komplett stummschalten, bei PC/AT-Systemen auch über das IMCR
+    outb(0x21, 0xFF);
+    outb(0xA1, 0xFF);
+    if (madt->pcat_compat) {
+        outb(0x22, 0x70);
+        outb(0x23, 0x01);
+    }
+
+    active = 1;
+    klog(LOG_INFO, "APIC: LAPIC %u at %08X, %d IOAPIC(s), PIC masked",
+         bsp, lapic_phys, ioapic_count);
+    return 1;
+}
+
+void apic_print_info(void) {
+    if (!active) {
+        kprint("APIC:     not used (8259 PIC)\n", TXT_GRAY);
+        return;
+    }
+    kprintf(TXT_NORMAL, "APIC:     %CLAPIC %u at 0x%08X%C, %d CPU(s)\n",
+            TXT_INFO, lapic_id(), lapic_phys, TXT_NORMAL, acpi_madt_info.cpu_count);
+    for (int i = 0; i < ioapic_count; i++) {
+        kprintf(TXT_NORMAL, "          IOAPIC %u: GSI %u-%u\n", ioapics[i].id,
+                ioapics[i].gsi_base, ioapics[i].gsi_base + ioapics[i].entries - 1);
+    }
+}
@@ -0,0 +1,69 @@
+// kernel/drivers/apic.h
+#ifndef KERNEL_DRIVERS_APIC_H
+#define KERNEL_DRIVERS_APIC_H
+
+#include <stdint.h>
+
+// ========================
+// LOCAL APIC
+// ========================
+#define MSR_APIC_BASE           0x1B
+#define APIC_BASE_ENABLE        (1 << 11)
+
+// Register (Offset zur LAPIC-Basis)
+#define LAPIC_ID                0x020
+#define LAPIC_VERSION           0x030
+#define LAPIC_TPR               0x080
+#define LAPIC_EOI               0x0B0
+#define LAPIC_SVR               0x0F0
+#define LAPIC_ESR               0x280
+#define LAPIC_LVT_TIMER         0x320
+#define LAPIC_LVT_LINT0         0x350
+#define LAPIC_LVT_LINT1         0x360
+#define LAPIC_LVT_ERROR         0x370
+
+#define LAPIC_SVR_ENABLE        0x100
+#define LVT_MASKED              0x10000
+#define LVT_NMI                 0x400
+
+// Vektoren oberhalb der ISA-IRQs
+#define APIC_SPURIOUS_VECTOR    0xFF
+
+// ========================
+// IO APIC
+// ========================
+#define IOAPIC_REGSEL           0x00
+#define IOAPIC_WINDOW           0x10
+#define IOAPIC_REG_ID           0x00
+#define IOAPIC_REG_VERSION      0x01
+#define IOAPIC_REG_REDTBL       0x10        // + 2 * Eintrag (low), +1 (high)
+
+// Redirection-Eintrag (low)
+#define IOAPIC_ACTIVE_LOW       (1 << 13)
+#define IOAPIC_LEVEL            (1 << 15)
+#define IOAPIC_MASKED           (1 << 16)
+
+// Nach acpi_init und pic_remap: LAPIC + IOAPICs aufsetzen, PIC abschalten.
+// Rückgabe 0 = kein APIC (CPU oder MADT), alles bleibt beim 8259.
+int apic_init(void);
+int apic_active(void);
+
+// Ein einziger MMIO-Schreibzugriff
+void lapic_eoi(void);
+uint8_t lapic_id(void);
+uint32_t lapic_address(void);
+
+// GSI auf Vektor und Ziel-CPU (APIC-ID) legen, bleibt maskiert.
+// flags = MPS INTI Flags aus der MADT (0 = Flanke, active high)
+int ioapic_route(uint32_t gsi, uint8_t vector, uint8_t dest, uint16_t flags);
+void ioapic_mask(uint32_t gsi);
+void ioapic_unmask(uint32_t gsi);
+
+// ISA-IRQ über die MADT-Overrides auf den IOAPIC abbilden
+void apic_irq_mask(uint8_t irq);
+void apic_irq_unmask(uint8_t irq);
+int apic_irq_affinity(uint8_t irq, uint8_t dest);
+
+void apic_print_info(void);
+
+#endif
@@ -0,0 +1,332 @@
+// kernel/drivers/fbcon.c - Textkonsole im linearen Framebuffer
+#include "fbcon.h"
+#include "../cpu/cpu.h"
+#include "../cpu/fpu.h"
+#include "../lib/mem.h"
+#include "../lib/bitmap.h"
+#include "../lib/printf.h"
+#include "../memory/paging.h"
+
+#define BACK_PITCH  FBCON_WIDTH         // in Pixeln
+#define CELL_EMPTY  0xFFFF              // Cache-Wert, der nie gezeichnet wurde
+
+static int active = 0;
+static int suspended = 0;               // LFB gehört gerade der GUI
+static int use_sse2 = 0;
+
+// Framebuffer laut Multiboot
+static uint32_t fb_phys = 0;
+static uint8_t* fb = 0;
+static uint32_t fb_pitch = 0;           // Bytes pro Pixelzeile
+static uint32_t fb_width = 0;
+static uint32_t fb_height = 0;
+static uint32_t origin_x = 0;           // Konsole zentriert
+static uint32_t origin_y = 0;
+
+// Back Buffer: nur die Konsolenfläche, 16-Byte-ausgerichtet (movdqa)
+static uint32_t back[FBCON_WIDTH * FBCON_HEIGHT] __attribute__((aligned(16)));
+
+// Was gerade im Back Buffer steht - gleiche Zellen werden übersprungen
+static uint16_t drawn[SCREEN_HEIGHT][SCREEN_WIDTH];
+
+// Pro Glyphenzeile (1 Byte) acht 32-Bit-Masken: 0xFFFFFFFF = Vordergrund
+static uint32_t glyph_mask[256][FONT_WIDTH] __attribute__((aligned(16)));
+
+static uint32_t palette[16];
+static uint32_t present_rows = 0;       // Bit y = Textzeile y in den LFB kopieren
+
+static int cur_x = -1;
+static int cur_y = -1;
+static int cur_drawn = 0;
+
+// Statistik
+static uint32_t glyphs_drawn = 0;
+static uint32_t scroll_moves = 0;
+static uint32_t rows_presented = 0;
+
+// VGA-Standardfarben (R, G, B)
+static const uint8_t vga_rgb[16][3] = {
+    {0x00, 0x00, 0x00}, {0x00, 0x00, 0xAA}, {0x00, 0xAA, 0x00}, {0x00, 0xAA, 0xAA},
+    {0xAA, 0x00, 0x00}, {0xAA, 0x00, 0xAA}, {0xAA, 0x55, 0x00}, {0xAA, 0xAA, 0xAA},
+    {0x55, 0x55, 0x55}, {0x55, 0x55, 0xFF}, {0x55, 0xFF, 0x55}, {0x55, 0xFF, 0xFF},
+    {0xFF, 0x55, 0x55}, {0xFF, 0x55, 0xFF}, {0xFF, 0xFF, 0x55}, {0xFF, 0xFF, 0xFF},
+};
+
+static inline uint32_t pack_channel(uint8_t value, uint8_t pos, uint8_t size) {
+    if(size == 0) return 0;
+    if(size > 8) size = 8;
+    return ((uint32_t)value >> (8 - size)) << pos;
+}
+
+// === rep stosl: n Pixel mit einer Farbe ===
+static inline void fill32(uint32_t* dest, uint32_t value, uint32_t n) {
+    uint32_t d0, d1;
+    asm volatile("rep stosl"
+                 : "=&c"(d0), "=&D"(d1)
+                 : "0"(n), "1"(dest), "a"(value)
+                 : "memory");
+}
+
+// Rand außerhalb der Konsole in der Hintergrundfarbe
+static void clear_framebuffer(void) {
+    uint32_t background = palette[THEME_BACKGROUND];
+    for(uint32_t y = 0; y < fb_height; y++) {
+        fill32((uint32_t*)(fb + y * fb_pitch), background, fb_width);
+    }
+}
+
+// ========================
+// INIT
+// ========================
+
+int fbcon_init(struct multiboot_info* mbi) {
+    if(!(mbi->flags & MULTIBOOT_INFO_FRAMEBUFFER)) return 0;
+    if(mbi->framebuffer_type != MULTIBOOT_FRAMEBUFFER_RGB) return 0;
+    if(mbi->framebuffer_bpp != FBCON_BPP) return 0;
+    if(mbi->framebuffer_addr >= 0x100000000ULL) return 0;
+    if(mbi->framebuffer_width < FBCON_WIDTH || mbi->framebuffer_height < FBCON_HEIGHT) return 0;
+
+    fb_phys = (uint32_t)mbi->framebuffer_addr;
+    fb = (uint8_t*)fb_phys;     // Paging ist noch aus: physisch = virtuell
+    fb_pitch = mbi->framebuffer_pitch;
+    fb_width = mbi->framebuffer_width;
+    fb_height = mbi->framebuffer_height;
+    origin_x = (fb_width - FBCON_WIDTH) / 2;
+    origin_y = (fb_height - FBCON_HEIGHT) / 2;
+
+    const uint8_t* ci = mbi->color_info;
+    for(int i = 0; i < 16; i++) {
+        palette[i] = pack_channel(vga_rgb[i][0], ci[0], ci[1]) |
+                     pack_channel(vga_rgb[i][1], ci[2], ci[3]) |
+                     pack_channel(vga_rgb[i][2], ci[4], ci[5]);
+    }
+
+    for(int bits = 0; bits < 256; bits++) {
+        for(int i = 0; i < FONT_WIDTH; i++) {
+            glyph_mask[bits][i] = (bits & (0x80 >> i)) ? 0xFFFFFFFF : 0;
+        }
+    }
+
+    for(int y = 0; y < SCREEN_HEIGHT; y++) {
+        memsetw(drawn[y], CELL_EMPTY, SCREEN_WIDTH);
+    }
+
+    clear_framebuffer();
+
+    use_sse2 = mem_sse_enabled();
+    active = 1;
+    return 1;
+}
+
+void fbcon_map(void) {
+    if(!active) return;
+    fb = (uint8_t*)map_mmio(fb_phys, fb_pitch * fb_height, MMIO_WC);
+}
+
+int fbcon_active(void) {
+    return active;
+}
+
+int fbcon_framebuffer(struct framebuffer* out) {
+    if(!active) return 0;
+    out->base = fb;
+    out->pitch = fb_pitch;
+    out->width = fb_width;
+    out->height = fb_height;
+    return 1;
+}
+
+// Die Konsole zeichnet weiter in den Back Buffer, nur nicht mehr in den LFB
+void fbcon_suspend(void) {
+    suspended = 1;
+}
+
+void fbcon_resume(void) {
+    if(!active || !suspended) return;
+    suspended = 0;
+    clear_framebuffer();
+    present_rows = (1u << SCREEN_HEIGHT) - 1;
+    fbcon_present();
+}
+
+// ========================
+// GLYPHEN
+// ========================
+
+// Pixel = bg ^ (Maske & (fg ^ bg)) - zwei 16-Byte-Stores pro Glyphenzeile
+static void render_cell_sse2(uint32_t* dest, const uint8_t* glyph, uint32_t fg, uint32_t bg) {
+    uint32_t diff = fg ^ bg;
+    uint32_t rows = FONT_HEIGHT;
+    asm volatile(
+        "movd %[diff], %%xmm6\n"
+        "pshufd $0, %%xmm6, %%xmm6\n"
+        "movd %[bg], %%xmm7\n"
+        "pshufd $0, %%xmm7, %%xmm7\n"
+        "1:\n"
+        "movzbl (%[glyph]), %%eax\n"
+        "shll $5, %%eax\n"
+        "movdqa (%[masks], %%eax), %%xmm0\n"
+        "movdqa 16(%[masks], %%eax), %%xmm1\n"
+        "pand %%xmm6, %%xmm0\n"
+        "pand %%xmm6, %%xmm1\n"
+        "pxor %%xmm7, %%xmm0\n"
+        "pxor %%xmm7, %%xmm1\n"
+        "movdqa %%xmm0, (%[dest])\n"
+        "movdqa %%xmm1, 16(%[dest])\n"
+        "incl %[glyph]\n"
+        "addl %[pitch], %[dest]\n"
+        "decl %[rows]\n"
+        "jnz 1b\n"
+        : [glyph] "+r"(glyph), [dest] "+r"(dest), [rows] "+r"(rows)
+        : [diff] "m"(diff), [bg] "m"(bg), [masks] "r"(glyph_mask),
+          [pitch] "i"(BACK_PITCH * 4)
+        : "eax", "memory", "cc");
+}
+
+static void render_cell_scalar(uint32_t* dest, const uint8_t* glyph, uint32_t fg, uint32_t bg) {
+    uint32_t diff = fg ^ bg;
+    for(int row = 0; row < FONT_HEIGHT; row++) {
+        const uint32_t* mask = glyph_mask[glyph[row]];
+        for(int i = 0; i < FONT_WIDTH; i++) {
+            dest[i] = bg ^ (mask[i] & diff);
+        }
+        dest += BACK_PITCH;
+    }
+}
+
+static inline uint32_t* cell_pixels(int x, int y) {
+    return back + (y * FONT_HEIGHT) * BACK_PITCH + x * FONT_WIDTH;
+}
+
+static void render_cell(int x, int y, uint16_t cell, int sse) {
+    const uint8_t* glyph = font8x16[(cell & 0xFF) & (FONT_GLYPHS - 1)];
+    uint32_t fg = palette[(cell >> 8) & 0x0F];
+    uint32_t bg = palette[(cell >> 12) & 0x0F];
+
+    if(sse) render_cell_sse2(cell_pixels(x, y), glyph, fg, bg);
+    else render_cell_scalar(cell_pixels(x, y), glyph, fg, bg);
+    glyphs_drawn++;
+}
+
+void fbcon_draw_line(int y, const uint16_t* cells) {
+    if(!active || y < 0 || y >= SCREEN_HEIGHT) return;
+
+    int sse = use_sse2 && kernel_fpu_begin();
+    int changed = 0;
+
+    for(int x = 0; x < SCREEN_WIDTH; x++) {
+        if(drawn[y][x] == cells[x]) continue;
+        drawn[y][x] = cells[x];
+        render_cell(x, y, cells[x], sse);
+        if(x == cur_x && y == cur_y) cur_drawn = 0;
+        changed = 1;
+    }
+
+    if(sse) kernel_fpu_end();
+    if(changed) present_rows |= 1u << y;
+}
+
+// ========================
+// CURSOR
+// ========================
+
+// Unterste zwei Pixelzeilen der Zelle in Vordergrundfarbe
+static void draw_cursor(void) {
+    uint16_t cell = drawn[cur_y][cur_x];
+    uint32_t color = palette[cell == CELL_EMPTY ? COLOR_WHITE : (cell >> 8) & 0x0F];
+    uint32_t* pixels = cell_pixels(cur_x, cur_y) + (FONT_HEIGHT - 2) * BACK_PITCH;
+
+    fill32(pixels, color, FONT_WIDTH);
+    fill32(pixels + BACK_PITCH, color, FONT_WIDTH);
+    cur_drawn = 1;
+    present_rows |= 1u << cur_y;
+}
+
+// Glyphe unter dem Cursor aus dem Cache wiederherstellen
+static void erase_cursor(void) {
+    if(cur_x < 0 || !cur_drawn) return;
+    uint16_t cell = drawn[cur_y][cur_x];
+    if(cell == CELL_EMPTY) cell = (TXT_NORMAL << 8) | ' ';
+
+    int sse = use_sse2 && kernel_fpu_begin();
+    render_cell(cur_x, cur_y, cell, sse);
+    if(sse) kernel_fpu_end();
+    cur_drawn = 0;
+    present_rows |= 1u << cur_y;
+}
+
+void fbcon_cursor(int x, int y) {
+    if(!active) return;
+    if(x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) x = -1;
+
+    if(x == cur_x && y == cur_y && (cur_drawn || x < 0)) return;
+
+    erase_cursor();
+    cur_x = x;
+    cur_y = y;
+    if(x >= 0) draw_cursor();
+}
+
+// ========================
+// SCROLLEN + AUSGABE
+// ========================
+
+void fbcon_scroll(int top, int rows, int lines) {
+    if(!active || lines <= 0 || lines >= rows) return;
+
+    // Der Cursor-Strich würde sonst mitwandern
+    erase_cursor();
+
+    uint32_t line_pixels = FONT_HEIGHT * BACK_PITCH;
+    memmove(back + top * line_pixels, back + (top + lines) * line_pixels,
+            (rows - lines) * line_pixels * 4);
+    memmove(drawn[top], drawn[top + lines], (rows - lines) * sizeof(drawn[0]));
+    for(int y = top + rows - lines; y < top + rows; y++) {
+        memsetw(drawn[y], CELL_EMPTY, SCREEN_WIDTH);
+    }
+
+    present_rows |= ((1u << rows) - 1) << top;
+    scroll_moves++;
+}
+
+void fbcon_present(void) {
+    if(!active || suspended) return;
+
+    uint32_t rows = present_rows;
+    present_rows = 0;
+
+    while(rows) {
+        int y = bit_scan_forward(rows);
+        int n = 1;
+        while(y + n < SCREEN_HEIGHT && ((rows >> (y + n)) & 1)) n++;
+        rows &= ~(((1u << n) - 1) << y);
+
+        uint32_t* src = back + y * FONT_HEIGHT * BACK_PITCH;
+        uint8_t* dest = fb + (origin_y + y * FONT_HEIGHT) * fb_pitch + origin_x * 4;
+        uint32_t pixel_rows = n * FONT_HEIGHT;
+
+        // Volle Breite: ein einziger zusammenhängender Block
+        if(fb_pitch == BACK_PITCH * 4) {
+            memcpy(dest, src, pixel_rows * fb_pitch);
+        } else {
+            for(uint32_t i = 0; i < pixel_rows; i++) {
+                memcpy(dest, src, BACK_PITCH * 4);
+                dest += fb_pitch;
+                src += BACK_PITCH;
+            }
+        }
+        rows_presented += n;
+    }
+}
+
+void fbcon_print_info(void) {
+    if(!active) {
+        kprint("Display:  80x25 VGA Text\n", TXT_NORMAL);
+        return;
+    }
+    kprintf(TXT_NORMAL, "Display:  %C%ux%ux%u framebuffer%C at %08X, 80x25 console (%s)\n",
+            TXT_INFO, fb_width, fb_height, FBCON_BPP, TXT_NORMAL, fb_phys,
+            use_sse2 ? "SSE2" : "scalar");
+    kprintf(TXT_NORMAL, "          %u glyphs drawn, %u scroll moves, %u rows presented\n",
+            glyphs_drawn, scroll_moves, rows_presented);
+}
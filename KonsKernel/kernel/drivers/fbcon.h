@@ -0,0 +1,54 @@
+// kernel/drivers/fbcon.h
+#ifndef KERNEL_DRIVERS_FBCON_H
+#define KERNEL_DRIVERS_FBCON_H
+
+#include <stdint.h>
+#include "font.h"
+#include "screen.h"
+#include "../kernel.h"
+
+// ========================
+// FRAMEBUFFER-KONSOLE
+// ========================
+// Das 80x25-Raster aus screen.c, zentriert im linearen Framebuffer (32 bpp).
+// Gezeichnet wird in einen Back Buffer im RAM, der LFB (WC) wird nur in
+// ganzen Pixelzeilen beschrieben und nie gelesen.
+#define FBCON_WIDTH   (SCREEN_WIDTH * FONT_WIDTH)
+#define FBCON_HEIGHT  (SCREEN_HEIGHT * FONT_HEIGHT)
+#define FBCON_BPP     32
+
+// Multiboot-Framebuffer übernehmen (vor paging_init, Back Buffer ist statisch).
+// Rückgabe 0 = kein passender Modus, die Konsole bleibt im VGA-Textmodus.
+int fbcon_init(struct multiboot_info* mbi);
+
+// Nach paging_init: LFB Write-Combining einblenden
+void fbcon_map(void);
+
+int fbcon_active(void);
+
+// LFB für die GUI: Zugriff holen, Konsole ab- und wieder anmelden
+struct framebuffer {
+    uint8_t* base;
+    uint32_t pitch;
+    uint32_t width;
+    uint32_t height;
+};
+int fbcon_framebuffer(struct framebuffer* out);
+void fbcon_suspend(void);
+void fbcon_resume(void);
+
+// Textzeilen [top, top+rows) um lines nach oben schieben (Back Buffer + Cache)
+void fbcon_scroll(int top, int rows, int lines);
+
+// Eine Textzeile zeichnen - nur Zellen, die sich geändert haben
+void fbcon_draw_line(int y, const uint16_t* cells);
+
+// Unterstrich-Cursor, x < 0 versteckt ihn
+void fbcon_cursor(int x, int y);
+
+// Geänderte Textzeilen aus dem Back Buffer in den LFB kopieren
+void fbcon_present(void);
+
+void fbcon_print_info(void);
+
+#endif
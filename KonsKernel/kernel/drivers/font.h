@@ -0,0 +1,13 @@
+// kernel/drivers/font.h
+#ifndef KERNEL_DRIVERS_FONT_H
+#define KERNEL_DRIVERS_FONT_H
+
+#include <stdint.h>
+
+#define FONT_WIDTH  8
+#define FONT_HEIGHT 16
+#define FONT_GLYPHS 128     // nur ASCII, fehlende Zeichen bleiben leer
+
+extern const uint8_t font8x16[FONT_GLYPHS][FONT_HEIGHT];
+
+#endif
@@ -5,6 +5,8 @@
 #include "../shell/history.h"
 #include "../lib/string.h"
 #include "../lib/utils.h"
+#include "../lib/log.h"
+#include "../memory/idt.h"
 
 extern int cursor_x;
 extern int cursor_y;
@@ -16,6 +18,13 @@ int ctrl_pressed = 0;
 int alt_pressed = 0;
 int caps_lock = 0;
 
+// Wer die Tastatur gerade exklusiv hat (z.B. die GUI), sonst die Shell
+static void (*grab_handler)(uint8_t scancode) = 0;
+
+void keyboard_set_grab(void (*handler)(uint8_t scancode)) {
+    grab_handler = handler;
+}
+
 // Deutsche Tastatur - Normal
 static const char scancode_ascii_de[] = {
     0, 0, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', 0, 0,
@@ -40,6 +49,11 @@ extern int cursor_y;
 extern int debug_mode;
 
 void handle_scancode(uint8_t scancode) {
+    if (grab_handler) {
+        grab_handler(scancode);
+        return;
+    }
+
     // Nur Tastendrücke (Make), keine Releases
     if (scancode & 0x80) {
         // Release - Shift/Ctrl/Alt tracking
@@ -54,6 +68,21 @@ void handle_scancode(uint8_t scancode) {
     if (scancode == 0x2A || scancode == 0x36) { shift_pressed = 1; return; }
     if (scancode == 0x1D) { ctrl_pressed = 1; return; }
     if (scancode == 0x38) { alt_pressed = 1; return; }
+
+    // Shift+PgUp / Shift+PgDn - Scrollback seitenweise
+    if (shift_pressed && scancode == 0x49) {
+        screen_scroll_view(SCREEN_HEIGHT - 2);
+        return;
+    }
+    if (shift_pressed && scancode == 0x51) {
+        screen_scroll_view(-(SCREEN_HEIGHT - 2));
+        return;
+    }
+
+    // Jede andere Taste springt zurück zur Live-Ansicht
+    if (screen_view_offset() > 0) {
+        screen_scroll_view(-screen_view_offset());
+    }
     if (scancode == 0x9D) {ctrl_pressed = 0; return;}
 
     // Caps Lock
@@ -84,17 +113,6 @@ void handle_scancode(uint8_t scancode) {
         return;
     }
 
-    // Debug Mode - Scancodes anzeigen
-    if (debug_mode) {
-        kprint("[", COLOR_YELLOW_ON_BLUE);
-        char hex[3];
-        hex[0] = "0123456789ABCDEF"[(scancode >> 4) & 0xF];
-        hex[1] = "0123456789ABCDEF"[scancode & 0xF];
-        hex[2] = '\0';
-        kprint(hex, COLOR_WHITE_ON_BLUE);
-        kprint("]", COLOR_YELLOW_ON_BLUE);
-    }
-
     // Pfeiltasten - History
     if (scancode == 0x48) {  // Up
         if (history_count > 0) {
@@ -248,8 +266,64 @@ void handle_scancode(uint8_t scancode) {
     }
 }
 
-// Wird von isr.c aufgerufen!
-void keyboard_handler(void) {
+// ========================
+// SCANCODE-RING (IRQ -> Hauptschleife)
+// ========================
+// Ein Erzeuger (IRQ1), ein Verbraucher (keyboard_poll): head schreibt nur
+// der IRQ, tail nur die Hauptschleife - kein Lock, kein cli nötig.
+#define KBD_RING_SIZE 128               // Zweierpotenz
+
+static volatile uint8_t kbd_ring[KBD_RING_SIZE];
+static volatile uint32_t kbd_head = 0;
+static volatile uint32_t kbd_tail = 0;
+static uint32_t kbd_dropped = 0;
+
+// Scancode einreihen - nichts dekodieren
+void keyboard_handler(uint8_t scancode) {
+    uint32_t head = kbd_head;
+    if (head - kbd_tail >= KBD_RING_SIZE) {
+        kbd_dropped++;
+        return;
+    }
+    kbd_ring[head & (KBD_RING_SIZE - 1)] = scancode;
+    asm volatile("" ::: "memory");      // erst der Eintrag, dann head
+    kbd_head = head + 1;
+}
+
+int keyboard_pending(void) {
+    return kbd_head != kbd_tail;
+}
+
+// Läuft außerhalb des IRQs: Dekodieren, Zeile bearbeiten, Befehle ausführen.
+// tail wird vor handle_scancode weitergezählt - so darf ein laufender Befehl
+// (z.B. gui) selbst wieder keyboard_poll aufrufen.
+void keyboard_poll(void) {
+    while (kbd_tail != kbd_head) {
+        uint32_t tail = kbd_tail;
+        uint8_t scancode = kbd_ring[tail & (KBD_RING_SIZE - 1)];
+        asm volatile("" ::: "memory");
+        kbd_tail = tail + 1;
+        handle_scancode(scancode);
+    }
+}
+
+uint32_t keyboard_dropped(void) {
+    return kbd_dropped;
+}
+
+// IRQ1: Port 0x60 genau einmal lesen, der Rest passiert in keyboard_poll
+static int keyboard_irq(void* ctx) {
     uint8_t scancode = inb(0x60);
-    handle_scancode(scancode);
+
+    if (debug_mode) {
+        klog(LOG_DEBUG, "kbd: %s %02X", (scancode & 0x80) ? "BRK" : "MAK", scancode);
+    }
+
+    keyboard_handler(scancode);
+    return IRQ_HANDLED;
+}
+
+void keyboard_init(void) {
+    irq_register(IRQ_BASE + 1, "keyboard", keyboard_irq, 0);
+    irq_unmask(1);
 }
@@ -4,10 +4,21 @@
 
 #include <stdint.h>
 
+// IRQ1 registrieren und freigeben
+void keyboard_init(void);
+
 // Scancode Handling
-void keyboard_handler(void);
+// Scancode in den Ring legen (IRQ1 oder andere Quellen)
+void keyboard_handler(uint8_t scancode);
+// Hauptschleife: Ring leeren und jeden Scancode an handle_scancode geben
+void keyboard_poll(void);
+int keyboard_pending(void);
+uint32_t keyboard_dropped(void);
 void handle_scancode(uint8_t scancode);
 
+// Alle Scancodes an handler statt an die Shell (0 = wieder Shell)
+void keyboard_set_grab(void (*handler)(uint8_t scancode));
+
 // Keyboard Zustand
 extern int shift_pressed;
 extern int ctrl_pressed;
@@ -1,6 +1,8 @@
 #include "mouse.h"
 #include "../lib/utils.h"
 #include "screen.h"
+#include "../memory/idt.h"
+#include "../cpu/cpu.h"
 
 // PS/2 Maus Ports
 #define PS2_DATA_PORT       0x60
@@ -19,35 +21,57 @@ static int mouse_cycle = 0;
 static uint8_t mouse_packet[3];
 static int mouse_ready = 0;
 
-// Auf Tastatur-Controller warten
-static void mouse_wait(uint8_t type) {
-    if (type == 0) { // Warten bis Daten bereit
-        while (!(inb(PS2_STATUS_PORT) & 1));
-    } else { // Warten bis schreiben möglich
-        while (inb(PS2_STATUS_PORT) & 2);
+#define MOUSE_IRQ 12
+#define MOUSE_WAIT_LOOPS 100000     // ein inb ~1 µs: rund 100 ms
+
+// Auf Tastatur-Controller warten, 0 = ok, -1 = Timeout
+static int mouse_wait(uint8_t type) {
+    for (int i = 0; i < MOUSE_WAIT_LOOPS; i++) {
+        uint8_t status = inb(PS2_STATUS_PORT);
+        if (type == 0 && (status & 1)) return 0;        // Daten bereit
+        if (type != 0 && !(status & 2)) return 0;       // schreiben möglich
     }
+    return -1;
 }
 
 // Befehl an Maus senden
-static void mouse_send_command(uint8_t cmd) {
+static int mouse_send_command(uint8_t cmd) {
     // Maus aufwecken
-    mouse_wait(1);
+    if (mouse_wait(1) < 0) return -1;
     outb(PS2_COMMAND_PORT, 0xD4);
 
-    mouse_wait(1);
+    if (mouse_wait(1) < 0) return -1;
     outb(PS2_DATA_PORT, cmd);
 
     // Auf Antwort warten
-    mouse_wait(0);
-    uint8_t ack = inb(PS2_DATA_PORT);
+    if (mouse_wait(0) < 0) return -1;
+    return inb(PS2_DATA_PORT) == 0xFA ? 0 : -1;
+}
 
-    if (ack != 0xFA) {
-        kprint("Mouse: Command failed\n", COLOR_RED);
-    }
+// Controller-Dialog: Interface an, IRQ12 im Konfigurationsbyte, Defaults, Enable.
+// Läuft mit gesperrten Interrupts - sonst holt keyboard_irq die Antworten
+// von Port 0x60 ab und legt sie als Scancodes in den Ring.
+static int mouse_setup_controller(void) {
+    if (mouse_wait(1) < 0) return -1;
+    outb(PS2_COMMAND_PORT, 0xA8);  // Maus Interface aktivieren
+
+    // IRQ12 im Controller-Konfigurationsbyte einschalten (Bit 1)
+    if (mouse_wait(1) < 0) return -1;
+    outb(PS2_COMMAND_PORT, 0x20);
+    if (mouse_wait(0) < 0) return -1;
+    uint8_t config = inb(PS2_DATA_PORT) | 0x02;
+    if (mouse_wait(1) < 0) return -1;
+    outb(PS2_COMMAND_PORT, 0x60);
+    if (mouse_wait(1) < 0) return -1;
+    outb(PS2_DATA_PORT, config);
+
+    if (mouse_send_command(MOUSE_SET_DEFAULTS) < 0) return -1;
+    return mouse_send_command(MOUSE_ENABLE);
 }
 
 // Maus initialisieren
 void mouse_init(void) {
+    if (mouse_ready) return;
     kprint("Initializing PS/2 mouse... ", COLOR_WHITE_ON_BLUE);
 
     // Maus-Paket-Variablen zurücksetzen
@@ -56,26 +80,29 @@ void mouse_init(void) {
     g_mouse.y = 384;
     g_mouse.buttons = 0;
 
-    // Maus aktivieren
-    mouse_wait(1);
-    outb(PS2_COMMAND_PORT, 0xA8);  // Maus Interface aktivieren
+    uint32_t flags = irq_save();
+    int result = mouse_setup_controller();
+    irq_restore(flags);
 
-    // Standardwerte setzen
-    mouse_send_command(MOUSE_SET_DEFAULTS);
+    if (result < 0) {
+        kprint("failed (no response from controller)\n", COLOR_RED);
+        return;
+    }
 
-    // Maus aktivieren
-    mouse_send_command(MOUSE_ENABLE);
+    irq_register(IRQ_BASE + MOUSE_IRQ, "mouse", mouse_handler, 0);
+    irq_unmask(MOUSE_IRQ);
+    mouse_ready = 1;
 
     kprint("OK\n", COLOR_GREEN_ON_BLUE);
 }
 
 // Maus Interrupt Handler (wird von IRQ12 aufgerufen!)
 // In mouse.c - die bestehende mouse_handler Funktion
-void mouse_handler(void) {
+int mouse_handler(void* ctx) {
     uint8_t status = inb(PS2_STATUS_PORT);
 
     // Prüfen ob Daten von Maus
-    if (!(status & 0x20)) return;
+    if (!(status & 0x20)) return IRQ_NONE;
 
     // Daten lesen
     uint8_t data = inb(PS2_DATA_PORT);
@@ -125,6 +152,7 @@ void mouse_handler(void) {
             if (g_mouse.y >= 768) g_mouse.y = 767;
             break;
     }
+    return IRQ_HANDLED;
 }
 
 void mouse_get_state(mouse_t* state) {
@@ -16,7 +16,7 @@ extern mouse_t g_mouse;
 
 // Funktionen
 void mouse_init(void);
-void mouse_handler(void);  // Wird vom Interrupt aufgerufen
+int mouse_handler(void* ctx);  // IRQ12, über irq_register
 void mouse_get_state(mouse_t* state);
 
 void mouse_set_position(int x, int y);
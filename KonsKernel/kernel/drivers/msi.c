@@ -0,0 +1,202 @@
+// kernel/drivers/msi.c - MSI und MSI-X für PCI-Geräte
+// Das Gerät schreibt die Nachricht direkt in den LAPIC: eigener Vektor pro
+// Queue, flankengesteuert, keine geteilten Leitungen und kein PIC-EOI.
+#include "pci.h"
+#include "apic.h"
+#include "../memory/paging.h"
+#include "../lib/log.h"
+
+static inline uint32_t msi_address(void) {
+    return MSI_ADDRESS_BASE | ((uint32_t)lapic_id() << 12);
+}
+
+// Vektor ist Teil der Nachricht: Fixed Delivery, Flanke
+static inline uint32_t msi_data(uint8_t vector) {
+    return vector;
+}
+
+// INTx aus, Bus Master an (MSI ist ein Speicher-Schreibzugriff des Geräts),
+// Memory an (MSI-X Tabelle liegt in einem BAR)
+static void intx_disable(struct pci_device* dev) {
+    uint16_t cmd = pci_read16(dev, PCI_COMMAND);
+    pci_write16(dev, PCI_COMMAND,
+                cmd | PCI_COMMAND_INTX_DISABLE | PCI_COMMAND_MASTER | PCI_COMMAND_MEMORY);
+}
+
+static void intx_enable(struct pci_device* dev) {
+    uint16_t cmd = pci_read16(dev, PCI_COMMAND);
+    pci_write16(dev, PCI_COMMAND, cmd & ~PCI_COMMAND_INTX_DISABLE);
+}
+
+static int register_vectors(struct pci_device* dev, int first, int count,
+                            irq_handler_t handler, void* ctx, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (!irq_register(first + i, name, handler, ctx)) {
+            while (--i >= 0) irq_unregister(first + i, handler, ctx);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// ========================
+// MSI-X
+// ========================
+static int enable_msix(struct pci_device* dev, int nvec, irq_handler_t handler, void* ctx) {
+    uint8_t cap = dev->msix_cap;
+    uint16_t control = pci_read16(dev, cap + PCI_MSIX_CONTROL);
+    int table_size = (control & PCI_MSIX_CTRL_SIZE) + 1;
+    if (nvec > table_size) nvec = table_size;
+
+    uint32_t table = pci_read32(dev, cap + PCI_MSIX_TABLE);
+    uint32_t bar = pci_bar_address(dev, table & 0x7);
+    if (!bar) return 0;
+
+    // Ein Block wie bei MSI: Tabelleneintrag i gehört zu irq_vector + i
+    int count = 1;
+    while (count * 2 <= nvec && count < 32) count *= 2;
+    int first = irq_alloc_vectors(count);
+    if (first < 0) return 0;
+
+    if (!register_vectors(dev, first, count, handler, ctx, "msi-x")) {
+        irq_free_vectors(first, count);
+        return 0;
+    }
+
+    uint32_t phys = bar + (table & ~0x7);
+    dev->msix_table = (volatile uint32_t*)map_mmio(phys, table_size * PCI_MSIX_ENTRY_SIZE,
+                                                   MMIO_UNCACHED);
+
+    intx_disable(dev);
+
+    // Funktion maskieren, während die Tabelle beschrieben wird
+    pci_write16(dev, cap + PCI_MSIX_CONTROL, control | PCI_MSIX_CTRL_ENABLE | PCI_MSIX_CTRL_MASKALL);
+
+    for (int i = 0; i < table_size; i++) {
+        volatile uint32_t* entry = dev->msix_table + i * (PCI_MSIX_ENTRY_SIZE / 4);
+        entry[3] = PCI_MSIX_ENTRY_CTRL_MASK;
+        if (i >= count) continue;
+        entry[0] = msi_address();
+        entry[1] = 0;
+        entry[2] = msi_data(first + i);
+        entry[3] = 0;
+    }
+
+    pci_write16(dev, cap + PCI_MSIX_CONTROL,
+                (control | PCI_MSIX_CTRL_ENABLE) & ~PCI_MSIX_CTRL_MASKALL);
+
+    dev->irq_mode = PCI_IRQ_MSIX;
+    dev->irq_vector = first;
+    dev->irq_count = count;
+    return count;
+}
+
+// ========================
+// MSI
+// ========================
+static int enable_msi(struct pci_device* dev, int nvec, irq_handler_t handler, void* ctx) {
+    uint8_t cap = dev->msi_cap;
+    uint16_t control = pci_read16(dev, cap + PCI_MSI_CONTROL);
+
+    // Multi-Message: Gerät kann 2^MMC, wir vergeben 2^MME <= nvec
+    int capable = 1 << ((control >> 1) & 0x7);
+    int log2 = 0;
+    while ((2 << log2) <= nvec && (2 << log2) <= capable && log2 < 5) log2++;
+    int count = 1 << log2;
+
+    int first = irq_alloc_vectors(count);
+    if (first < 0) return 0;
+
+    if (!register_vectors(dev, first, count, handler, ctx, "msi")) {
+        irq_free_vectors(first, count);
+        return 0;
+    }
+
+    int is64 = control & PCI_MSI_CTRL_64BIT;
+    uint8_t data_reg = cap + (is64 ? 0x0C : 0x08);
+
+    pci_write32(dev, cap + PCI_MSI_ADDR_LO, msi_address());
+    if (is64) pci_write32(dev, cap + PCI_MSI_ADDR_HI, 0);
+    pci_write16(dev, data_reg, msi_data(first));
+
+    // Bei Per-Vector-Masking alle eigenen Vektoren freigeben
+    if (control & PCI_MSI_CTRL_MASKING) {
+        pci_write32(dev, cap + (is64 ? 0x10 : 0x0C), 0);
+    }
+
+    intx_disable(dev);
+    control = (control & ~(0x7 << 4)) | (log2 << 4) | PCI_MSI_CTRL_ENABLE;
+    pci_write16(dev, cap + PCI_MSI_CONTROL, control);
+
+    dev->irq_mode = PCI_IRQ_MSI;
+    dev->irq_vector = first;
+    dev->irq_count = count;
+    return count;
+}
+
+int pci_enable_msi(struct pci_device* dev, int nvec, irq_handler_t handler, void* ctx) {
+    if (!apic_active() || nvec < 1 || dev->irq_mode != PCI_IRQ_INTX) return 0;
+
+    int count = 0;
+    if (dev->msix_cap) count = enable_msix(dev, nvec, handler, ctx);
+    if (!count && dev->msi_cap) count = enable_msi(dev, nvec, handler, ctx);
+
+    if (count) {
+        dev->irq_handler = handler;
+        dev->irq_ctx = ctx;
+        klog(LOG_INFO, "PCI %u:%u.%u: %s, %d vector(s) from %u", dev->bus, dev->slot,
+             dev->func, dev->irq_mode == PCI_IRQ_MSIX ? "MSI-X" : "MSI", count, dev->irq_vector);
+    }
+    return count;
+}
+
+void pci_disable_msi(struct pci_device* dev) {
+    if (dev->irq_mode == PCI_IRQ_INTX) return;
+
+    if (dev->irq_mode == PCI_IRQ_MSIX) {
+        uint16_t control = pci_read16(dev, dev->msix_cap + PCI_MSIX_CONTROL);
+        pci_write16(dev, dev->msix_cap + PCI_MSIX_CONTROL, control & ~PCI_MSIX_CTRL_ENABLE);
+    } else {
+        uint16_t control = pci_read16(dev, dev->msi_cap + PCI_MSI_CONTROL);
+        pci_write16(dev, dev->msi_cap + PCI_MSI_CONTROL, control & ~PCI_MSI_CTRL_ENABLE);
+    }
+    intx_enable(dev);
+
+    for (int i = 0; i < dev->irq_count; i++) {
+        irq_unregister(dev->irq_vector + i, dev->irq_handler, dev->irq_ctx);
+    }
+    irq_free_vectors(dev->irq_vector, dev->irq_count);
+
+    dev->irq_mode = PCI_IRQ_INTX;
+    dev->irq_count = 0;
+}
+
+// ========================
+// MASKIERUNG PRO VEKTOR
+// ========================
+static void msi_set_mask(struct pci_device* dev, int index, int masked) {
+    if (index < 0 || index >= dev->irq_count) return;
+
+    if (dev->irq_mode == PCI_IRQ_MSIX) {
+        volatile uint32_t* ctrl = dev->msix_table + index * (PCI_MSIX_ENTRY_SIZE / 4) + 3;
+        *ctrl = masked ? (*ctrl | PCI_MSIX_ENTRY_CTRL_MASK) : (*ctrl & ~PCI_MSIX_ENTRY_CTRL_MASK);
+        return;
+    }
+
+    // MSI nur mit Per-Vector-Masking, sonst lässt sich nichts einzeln sperren
+    uint16_t control = pci_read16(dev, dev->msi_cap + PCI_MSI_CONTROL);
+    if (dev->irq_mode != PCI_IRQ_MSI || !(control & PCI_MSI_CTRL_MASKING)) return;
+
+    uint8_t mask_reg = dev->msi_cap + ((control & PCI_MSI_CTRL_64BIT) ? 0x10 : 0x0C);
+    uint32_t bits = pci_read32(dev, mask_reg);
+    bits = masked ? (bits | (1u << index)) : (bits & ~(1u << index));
+    pci_write32(dev, mask_reg, bits);
+}
+
+void pci_msi_mask(struct pci_device* dev, int index) {
+    msi_set_mask(dev, index, 1);
+}
+
+void pci_msi_unmask(struct pci_device* dev, int index) {
+    msi_set_mask(dev, index, 0);
+}
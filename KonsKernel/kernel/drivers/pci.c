@@ -1,21 +1,286 @@
 #include "pci.h"
 #include "screen.h"
 #include "../lib/utils.h"
-#include "keyboard.h"  // für input
-
-static void wait_for_key(void) {
-    while(!(inb(0x64) & 1));
-    inb(0x60);
+#include "../lib/mem.h"
+#include "../lib/printf.h"
+#include "../lib/log.h"
+#include "../cpu/cpu.h"
+#include "../memory/paging.h"
+#include "acpi.h"
+
+// Einmal beim Booten gefüllt, danach lesen Treiber und 'pci' nur noch hier
+static struct pci_device devices[PCI_MAX_DEVICES];
+static int device_count = 0;
+static int bus_count = 0;
+static uint32_t bus_seen[256 / 32];
+
+// ========================
+// KONFIGURATIONSRAUM
+// ========================
+// ECAM (PCIe): 4 KB pro Funktion direkt im Speicher, ein mov pro Zugriff.
+// Sonst Mechanismus #1 über 0xCF8/0xCFC - nur 256 Byte, zwei Portzugriffe.
+static volatile uint8_t* ecam = 0;
+static uint8_t ecam_start_bus = 0;
+static uint8_t ecam_end_bus = 0;
+
+static inline volatile uint32_t* ecam_address(uint8_t bus, uint8_t slot, uint8_t func, uint16_t offset) {
+    if (!ecam || bus < ecam_start_bus || bus > ecam_end_bus) return 0;
+    return (volatile uint32_t*)(ecam + ((uint32_t)(bus - ecam_start_bus) << 20) +
+                                (slot << 15) + (func << 12) + (offset & 0xFFC));
 }
 
 // PCI Konfiguration lesen
-uint32_t pci_config_read(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset) {
-    if (slot > 31 || func > 7) return 0xFFFFFFFF;
+uint32_t pci_config_read(uint8_t bus, uint8_t slot, uint8_t func, uint16_t offset) {
+    if (slot > 31 || func > 7 || offset > 0xFFF) return 0xFFFFFFFF;
+
+    volatile uint32_t* reg = ecam_address(bus, slot, func, offset);
+    if (reg) return *reg;
+    if (offset > 0xFF) return 0xFFFFFFFF;
+
+    // Adresse + Daten dürfen nicht von einem IRQ-Handler unterbrochen werden
+    uint32_t address = (uint32_t)((bus << 16) | (slot << 11) | (func << 8) | (offset & 0xFC) | 0x80000000);
+    uint32_t flags = irq_save();
+    outl(PCI_CONFIG_ADDRESS, address);
+    uint32_t value = inl(PCI_CONFIG_DATA);
+    irq_restore(flags);
+    return value;
+}
+
+void pci_config_write(uint8_t bus, uint8_t slot, uint8_t func, uint16_t offset, uint32_t value) {
+    if (slot > 31 || func > 7 || offset > 0xFFF) return;
+
+    volatile uint32_t* reg = ecam_address(bus, slot, func, offset);
+    if (reg) {
+        *reg = value;
+        return;
+    }
+    if (offset > 0xFF) return;
 
     uint32_t address = (uint32_t)((bus << 16) | (slot << 11) | (func << 8) | (offset & 0xFC) | 0x80000000);
+    uint32_t flags = irq_save();
     outl(PCI_CONFIG_ADDRESS, address);
-    io_wait();
-    return inl(PCI_CONFIG_DATA);
+    outl(PCI_CONFIG_DATA, value);
+    irq_restore(flags);
+}
+
+int pci_ecam_enabled(void) {
+    return ecam != 0;
+}
+
+// MCFG aus acpi_init übernehmen, nur Busse des Bereichs einblenden
+static void pci_ecam_init(void) {
+    if (!acpi_ecam.present) return;
+
+    uint32_t size = ((uint32_t)(acpi_ecam.end_bus - acpi_ecam.start_bus) + 1) << 20;
+    ecam = (volatile uint8_t*)map_mmio(acpi_ecam.base, size, MMIO_UNCACHED);
+    ecam_start_bus = acpi_ecam.start_bus;
+    ecam_end_bus = acpi_ecam.end_bus;
+}
+
+// ========================
+// GERÄTE-ZUGRIFF
+// ========================
+uint32_t pci_read32(struct pci_device* dev, uint16_t offset) {
+    return pci_config_read(dev->bus, dev->slot, dev->func, offset);
+}
+
+uint16_t pci_read16(struct pci_device* dev, uint16_t offset) {
+    return pci_read32(dev, offset) >> ((offset & 2) * 8);
+}
+
+uint8_t pci_read8(struct pci_device* dev, uint16_t offset) {
+    return pci_read32(dev, offset) >> ((offset & 3) * 8);
+}
+
+void pci_write32(struct pci_device* dev, uint16_t offset, uint32_t value) {
+    pci_config_write(dev->bus, dev->slot, dev->func, offset, value);
+}
+
+// Ganzes Dword lesen und nur die eigene Hälfte ersetzen. Achtung beim Status-
+// register (RW1C): PCI_COMMAND schreibt die Statusbits als 0 zurück.
+void pci_write16(struct pci_device* dev, uint16_t offset, uint16_t value) {
+    int shift = (offset & 2) * 8;
+    uint32_t dword = pci_read32(dev, offset);
+    if (offset == PCI_COMMAND) dword &= 0x0000FFFF;
+    dword = (dword & ~(0xFFFF << shift)) | ((uint32_t)value << shift);
+    pci_write32(dev, offset, dword);
+}
+
+int pci_get_device(uint8_t bus, uint8_t slot, uint8_t func, struct pci_device* dev) {
+    uint32_t vendev = pci_config_read(bus, slot, func, PCI_VENDOR_ID);
+    if ((vendev & 0xFFFF) == 0xFFFF) return 0;
+
+    uint32_t class_reg = pci_config_read(bus, slot, func, PCI_CLASS_REVISION);
+
+    memset(dev, 0, sizeof(*dev));
+    dev->bus = bus;
+    dev->slot = slot;
+    dev->func = func;
+    dev->vendor = vendev & 0xFFFF;
+    dev->device = vendev >> 16;
+    dev->class_code = class_reg >> 24;
+    dev->subclass = class_reg >> 16;
+    dev->prog_if = class_reg >> 8;
+    dev->header_type = pci_read8(dev, PCI_HEADER_TYPE);
+    dev->irq_mode = PCI_IRQ_INTX;
+    dev->msi_cap = pci_find_capability(dev, PCI_CAP_MSI);
+    dev->msix_cap = pci_find_capability(dev, PCI_CAP_MSIX);
+    dev->pcie_cap = pci_find_capability(dev, PCI_CAP_PCIE);
+
+    uint32_t irq_reg = pci_read32(dev, PCI_INTERRUPT_LINE);
+    dev->irq_line = irq_reg & 0xFF;
+    dev->irq_pin = (irq_reg >> 8) & 0xFF;
+    return 1;
+}
+
+uint8_t pci_find_capability(struct pci_device* dev, uint8_t cap_id) {
+    if (!(pci_read16(dev, PCI_STATUS) & PCI_STATUS_CAP_LIST)) return 0;
+
+    uint8_t ptr = pci_read8(dev, PCI_CAP_PTR) & 0xFC;
+
+    // Höchstens 48 Einträge passen in 256 Byte - schützt vor Schleifen
+    for (int i = 0; i < 48 && ptr >= 0x40; i++) {
+        uint16_t header = pci_read16(dev, ptr);
+        if ((header & 0xFF) == cap_id) return ptr;
+        ptr = (header >> 8) & 0xFC;
+    }
+    return 0;
+}
+
+// Extended Capabilities ab 0x100 (nur mit ECAM erreichbar)
+uint16_t pci_find_ext_capability(struct pci_device* dev, uint16_t cap_id) {
+    if (!ecam_address(dev->bus, dev->slot, dev->func, 0x100)) return 0;
+
+    uint16_t ptr = 0x100;
+    for (int i = 0; i < 960 && ptr >= 0x100; i++) {
+        uint32_t header = pci_read32(dev, ptr);
+        if (header == 0 || header == 0xFFFFFFFF) return 0;
+        if ((header & 0xFFFF) == cap_id) return ptr;
+        ptr = (header >> 20) & 0xFFC;
+    }
+    return 0;
+}
+
+uint32_t pci_bar_address(struct pci_device* dev, int bar) {
+    if (bar < 0 || bar > 5 || (dev->bar_flags[bar] & PCI_BAR_IO)) return 0;
+    return dev->bar[bar];
+}
+
+// ========================
+// ENUMERATION
+// ========================
+// Größe über das Schreiben von Einsen ermitteln, Decoding solange aus
+static void pci_read_bars(struct pci_device* dev) {
+    int bars = (dev->header_type & 0x7F) == 0 ? 6 : (dev->header_type & 0x7F) == 1 ? 2 : 0;
+
+    uint16_t cmd = pci_read16(dev, PCI_COMMAND);
+    pci_write16(dev, PCI_COMMAND, cmd & ~(PCI_COMMAND_IO | PCI_COMMAND_MEMORY));
+
+    for (int i = 0; i < bars; i++) {
+        uint8_t reg = PCI_BAR0 + i * 4;
+        uint32_t value = pci_read32(dev, reg);
+
+        pci_write32(dev, reg, 0xFFFFFFFF);
+        uint32_t mask = pci_read32(dev, reg);
+        pci_write32(dev, reg, value);
+
+        if (mask == 0 || mask == 0xFFFFFFFF) continue;
+
+        if (value & 1) {
+            dev->bar_flags[i] = PCI_BAR_IO;
+            dev->bar[i] = value & ~0x3;
+            dev->bar_size[i] = (~(mask & ~0x3) & 0xFFFF) + 1;
+            continue;
+        }
+
+        dev->bar[i] = value & ~0xF;
+        dev->bar_size[i] = ~(mask & ~0xF) + 1;
+        if (value & 0x8) dev->bar_flags[i] |= PCI_BAR_PREFETCH;
+
+        // 64 Bit: obere Hälfte belegt den nächsten BAR mit
+        if ((value & 0x6) == 0x4 && i + 1 < bars) {
+            dev->bar_flags[i] |= PCI_BAR_64;
+            if (pci_read32(dev, reg + 4) != 0) dev->bar[i] = 0;    // über 4 GB: nicht erreichbar
+            i++;
+        }
+    }
+
+    pci_write16(dev, PCI_COMMAND, cmd);
+}
+
+static void pci_scan_bus(uint8_t bus);
+
+static void pci_add_function(uint8_t bus, uint8_t slot, uint8_t func) {
+    if (device_count >= PCI_MAX_DEVICES) {
+        klog(LOG_WARN, "PCI: device table full, %u:%u.%u ignored", bus, slot, func);
+        return;
+    }
+
+    struct pci_device* dev = &devices[device_count];
+    if (!pci_get_device(bus, slot, func, dev)) return;
+    device_count++;
+
+    pci_read_bars(dev);
+
+    // PCI-to-PCI Bridge: dahinterliegenden Bus gleich mit aufnehmen
+    if ((dev->header_type & 0x7F) == 1 && dev->class_code == PCI_CLASS_BRIDGE &&
+        dev->subclass == PCI_SUBCLASS_PCI_BRIDGE) {
+        dev->secondary_bus = pci_read8(dev, PCI_SECONDARY_BUS);
+        if (dev->secondary_bus != 0) pci_scan_bus(dev->secondary_bus);
+    }
+}
+
+static void pci_scan_bus(uint8_t bus) {
+    if (bus_seen[bus / 32] & (1u << (bus % 32))) return;
+    bus_seen[bus / 32] |= 1u << (bus % 32);
+    bus_count++;
+
+    for (uint8_t slot = 0; slot < 32; slot++) {
+        uint32_t vendev = pci_config_read(bus, slot, 0, PCI_VENDOR_ID);
+        if ((vendev & 0xFFFF) == 0xFFFF) continue;
+
+        int first = device_count;
+        pci_add_function(bus, slot, 0);
+        if (device_count == first || !(devices[first].header_type & 0x80)) continue;
+
+        for (uint8_t func = 1; func < 8; func++) {
+            if (pci_device_exists(bus, slot, func)) pci_add_function(bus, slot, func);
+        }
+    }
+}
+
+// ========================
+// TABELLE
+// ========================
+int pci_device_count(void) {
+    return device_count;
+}
+
+struct pci_device* pci_device_at(int index) {
+    if (index < 0 || index >= device_count) return 0;
+    return &devices[index];
+}
+
+// 0xFF bei subclass/prog_if = beliebig; index zählt die Treffer
+struct pci_device* pci_find_class(uint8_t class_code, uint8_t subclass, uint8_t prog_if, int index) {
+    for (int i = 0; i < device_count; i++) {
+        struct pci_device* dev = &devices[i];
+        if (dev->class_code != class_code) continue;
+        if (subclass != 0xFF && dev->subclass != subclass) continue;
+        if (prog_if != 0xFF && dev->prog_if != prog_if) continue;
+        if (index-- == 0) return dev;
+    }
+    return 0;
+}
+
+struct pci_device* pci_find_device(uint16_t vendor, uint16_t device, int index) {
+    for (int i = 0; i < device_count; i++) {
+        struct pci_device* dev = &devices[i];
+        if (dev->vendor != vendor) continue;
+        if (device != 0xFFFF && dev->device != device) continue;
+        if (index-- == 0) return dev;
+    }
+    return 0;
 }
 
 // Prüfen ob Gerät existiert
@@ -54,143 +319,102 @@ uint8_t pci_get_device_color(uint8_t class_code) {
 }
 
 // Einzelnes Gerät ausgeben
-void pci_print_device(uint8_t bus, uint8_t slot, uint8_t func) {
-    char buf[16];
-
-    uint32_t vendev = pci_config_read(bus, slot, func, 0);
-    uint16_t vendor = vendev & 0xFFFF;
-    uint16_t device = (vendev >> 16) & 0xFFFF;
-
-    uint32_t class_reg = pci_config_read(bus, slot, func, 0x08);
-    uint8_t class_code = (class_reg >> 24) & 0xFF;
-    uint8_t subclass = (class_reg >> 16) & 0xFF;
-
-    uint32_t header_reg = pci_config_read(bus, slot, func, 0x0C);
-    uint8_t header_type = (header_reg >> 16) & 0xFF;
-    int is_multi = (header_type & 0x80) ? 1 : 0;
-
-    // Bus/Slot/Funktion
-    kprint("  ", TXT_NORMAL);
-    int_to_string(bus, buf);
-    kprint(buf, TXT_GRAY);
-    kprint(":", TXT_GRAY);
-    int_to_string(slot, buf);
-    kprint(buf, TXT_GRAY);
-    if (func > 0) {
-        kprint(".", TXT_GRAY);
-        int_to_string(func, buf);
-        kprint(buf, TXT_GRAY);
-    }
-
-    kprint("  ", TXT_NORMAL);
-
-    // Vendor:Device
-    hex_to_string(vendor, buf);
-    kprint(buf, TXT_CYAN);
-    kprint(":", TXT_NORMAL);
-    hex_to_string(device, buf);
-    kprint(buf, TXT_NORMAL);
+void pci_print_device(struct pci_device* dev) {
+    kprintf(TXT_GRAY, "  %02X:%02X.%u  ", dev->bus, dev->slot, dev->func);
+    kprintf(TXT_CYAN, "%04X", dev->vendor);
+    kprintf(TXT_NORMAL, ":%04X", dev->device);
 
     kprint("  [", TXT_GRAY);
-
-    // Gerätetyp
-    const char* type = pci_get_device_type(class_code, subclass);
-    uint8_t color = pci_get_device_color(class_code);
-    kprint(type, color);
+    kprint(pci_get_device_type(dev->class_code, dev->subclass), pci_get_device_color(dev->class_code));
 
     // AHCI Markierung
-    if (class_code == 0x01 && subclass == 0x06) {
+    if (dev->class_code == 0x01 && dev->subclass == 0x06) {
         kprint(" AHCI", COLOR_LIGHT_GREEN);
     }
 
     kprint("]", TXT_GRAY);
 
-    if (is_multi) {
+    if (dev->header_type & 0x80) {
         kprint(" [MF]", TXT_YELLOW);
     }
+    if (dev->msix_cap) kprint(" MSI-X", TXT_GRAY);
+    else if (dev->msi_cap) kprint(" MSI", TXT_GRAY);
+    if (dev->secondary_bus) kprintf(TXT_GRAY, " -> bus %u", dev->secondary_bus);
 
     kprint("\n", TXT_NORMAL);
+
+    for (int i = 0; i < 6; i++) {
+        if (!dev->bar_size[i]) continue;
+        uint32_t size = dev->bar_size[i];
+        kprintf(TXT_GRAY, "      BAR%d %s %08X  %u %s%s\n", i,
+                (dev->bar_flags[i] & PCI_BAR_IO) ? "I/O" : "MEM", dev->bar[i],
+                size >= 1024 * 1024 ? size >> 20 : size >= 1024 ? size >> 10 : size,
+                size >= 1024 * 1024 ? "MB" : size >= 1024 ? "KB" : "B",
+                (dev->bar_flags[i] & PCI_BAR_64) ? " 64-bit" : "");
+    }
 }
 
-// NEU: Haupt-PCI-Scan-Funktion (für Command)
+// Ausgabe aus der Tabelle - kein Zugriff auf den Konfigurationsraum
 void pci_scan_and_print(void) {
     kprint("\n", TXT_NORMAL);
     kprint("╔════════════════════════════════════════════╗\n", TXT_CYAN);
     kprint("║           PCI DEVICE SCANNER              ║\n", TXT_CYAN);
     kprint("╚════════════════════════════════════════════╝\n", TXT_CYAN);
 
-    int device_count = 0;
-    int ahci_count = 0;
-
-    // Teste PCI Verfügbarkeit
-    uint32_t test_read = pci_config_read(0, 0, 0, 0);
-    if ((test_read & 0xFFFF) == 0xFFFF) {
+    if (device_count == 0) {
         kprint("❌ PCI nicht verfügbar!\n", TXT_ERROR);
         return;
     }
 
-    kprint("\nBus Slot  Vendor:Device  [Type]\n", TXT_GRAY);
+    kprint("\nBus:Sl.F  Vendor:Device  [Type]\n", TXT_GRAY);
     kprint("────────────────────────────────────────────\n", TXT_GRAY);
 
-    // Scanne Busse 0-2 (meistens ausreichend)
-    for (uint8_t bus = 0; bus < 3; bus++) {
-        for (uint8_t slot = 0; slot < 32; slot++) {
-            if (pci_device_exists(bus, slot, 0)) {
-                pci_print_device(bus, slot, 0);
-                device_count++;
-
-                // Class für AHCI check
-                uint32_t class_reg = pci_config_read(bus, slot, 0, 0x08);
-                uint8_t class = (class_reg >> 24) & 0xFF;
-                uint8_t subclass = (class_reg >> 16) & 0xFF;
-                if (class == 0x01 && subclass == 0x06) ahci_count++;
-
-                // Multifunktion?
-                uint32_t header = pci_config_read(bus, slot, 0, 0x0C);
-                if (header & 0x800000) {
-                    for (uint8_t func = 1; func < 8; func++) {
-                        if (pci_device_exists(bus, slot, func)) {
-                            pci_print_device(bus, slot, func);
-                            device_count++;
-
-                            class_reg = pci_config_read(bus, slot, func, 0x08);
-                            class = (class_reg >> 24) & 0xFF;
-                            subclass = (class_reg >> 16) & 0xFF;
-                            if (class == 0x01 && subclass == 0x06) ahci_count++;
-                        }
-                    }
-                }
-            }
-        }
+    int ahci_count = 0;
+    for (int i = 0; i < device_count; i++) {
+        pci_print_device(&devices[i]);
+        if (devices[i].class_code == 0x01 && devices[i].subclass == 0x06) ahci_count++;
     }
 
     kprint("────────────────────────────────────────────\n", TXT_GRAY);
 
-    char buf[16];
-    int_to_string(device_count, buf);
     kprint("📊 Gefundene Geräte: ", TXT_SUCCESS);
-    kprint(buf, TXT_CYAN);
-    kprint("\n", TXT_NORMAL);
+    kprintf(TXT_CYAN, "%d", device_count);
+    kprintf(TXT_GRAY, " (%d Bus%s)\n", bus_count, bus_count == 1 ? "" : "se");
+    if (ecam) kprintf(TXT_GRAY, "Config: ECAM at %08X, bus %u-%u\n", acpi_ecam.base,
+                      ecam_start_bus, ecam_end_bus);
+    else kprint("Config: port I/O (0xCF8/0xCFC)\n", TXT_GRAY);
 
     if (ahci_count > 0) {
-        int_to_string(ahci_count, buf);
         kprint("💾 AHCI Controller: ", TXT_SUCCESS);
-        kprint(buf, TXT_CYAN);
-        kprint("\n", TXT_NORMAL);
+        kprintf(TXT_CYAN, "%d\n", ahci_count);
     } else {
         kprint("💾 AHCI: Keine gefunden\n", TXT_WARNING);
     }
-
-    kprint("\nDrücke eine Taste für die Shell...", TXT_GRAY);
-    wait_for_key();
 }
 
-// Alte init-Funktion (minimal)
+// Einmalige Enumeration: vom Host Bridge aus alle Bridges rekursiv verfolgen
 void pci_init(void) {
-    // Nur kurz prüfen ob PCI da ist, ohne Ausgabe
-    uint32_t test_read = pci_config_read(0, 0, 0, 0);
-    if ((test_read & 0xFFFF) == 0xFFFF) {
+    device_count = 0;
+    bus_count = 0;
+    memset(bus_seen, 0, sizeof(bus_seen));
+    pci_ecam_init();
+
+    uint32_t host = pci_config_read(0, 0, 0, PCI_VENDOR_ID);
+    if ((host & 0xFFFF) == 0xFFFF) {
         kprint("PCI: Nicht verfügbar\n", TXT_ERROR);
+        return;
     }
-    // Keine Ausgabe - alles sauber!
+
+    // Multifunktions-Host-Bridge: Funktion n ist der Host Controller für Bus n
+    uint8_t header = pci_config_read(0, 0, 0, 0x0C) >> 16;
+    if (!(header & 0x80)) {
+        pci_scan_bus(0);
+    } else {
+        for (uint8_t func = 0; func < 8; func++) {
+            if (pci_device_exists(0, 0, func)) pci_scan_bus(func);
+        }
+    }
+
+    klog(LOG_INFO, "PCI: %d devices on %d bus(es) via %s", device_count, bus_count,
+         ecam ? "ECAM" : "port I/O");
 }
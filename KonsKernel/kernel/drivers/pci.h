@@ -2,14 +2,149 @@
 #define PCI_H
 
 #include <stdint.h>
+#include "../memory/idt.h"
 
 #define PCI_CONFIG_ADDRESS 0xCF8
 #define PCI_CONFIG_DATA    0xCFC
 
+// Konfigurationsraum (Type 0 Header)
+#define PCI_VENDOR_ID      0x00
+#define PCI_COMMAND        0x04
+#define PCI_STATUS         0x06
+#define PCI_CLASS_REVISION 0x08
+#define PCI_HEADER_TYPE    0x0E
+#define PCI_BAR0           0x10
+#define PCI_SECONDARY_BUS  0x19     // Type 1 (Bridge)
+#define PCI_CAP_PTR        0x34
+#define PCI_INTERRUPT_LINE 0x3C
+
+#define PCI_COMMAND_IO            (1 << 0)
+#define PCI_COMMAND_MEMORY        (1 << 1)
+#define PCI_COMMAND_MASTER        (1 << 2)
+#define PCI_COMMAND_INTX_DISABLE  (1 << 10)
+#define PCI_STATUS_CAP_LIST       (1 << 4)
+
+#define PCI_CLASS_BRIDGE          0x06
+#define PCI_SUBCLASS_PCI_BRIDGE   0x04
+
+// BAR-Eigenschaften
+#define PCI_BAR_IO         0x01
+#define PCI_BAR_64         0x02
+#define PCI_BAR_PREFETCH   0x04
+
+#define PCI_MAX_DEVICES    64
+
+// Capability IDs
+#define PCI_CAP_MSI        0x05
+#define PCI_CAP_PCIE       0x10
+#define PCI_CAP_MSIX       0x11
+
+// MSI Capability (Offsets zur Capability)
+#define PCI_MSI_CONTROL    0x02
+#define PCI_MSI_ADDR_LO    0x04
+#define PCI_MSI_ADDR_HI    0x08     // nur 64-Bit
+#define PCI_MSI_CTRL_ENABLE  (1 << 0)
+#define PCI_MSI_CTRL_64BIT   (1 << 7)
+#define PCI_MSI_CTRL_MASKING (1 << 8)
+
+// MSI-X Capability
+#define PCI_MSIX_CONTROL   0x02
+#define PCI_MSIX_TABLE     0x04     // Offset | BIR
+#define PCI_MSIX_PBA       0x08
+#define PCI_MSIX_CTRL_SIZE   0x07FF
+#define PCI_MSIX_CTRL_MASKALL (1 << 14)
+#define PCI_MSIX_CTRL_ENABLE (1 << 15)
+#define PCI_MSIX_ENTRY_SIZE  16
+#define PCI_MSIX_ENTRY_CTRL_MASK 1
+
+// Nachrichtenadresse: LAPIC-Fenster, Ziel-APIC-ID in Bit 12-19
+#define MSI_ADDRESS_BASE   0xFEE00000
+
+// Interrupt-Modus eines Geräts
+#define PCI_IRQ_INTX       0
+#define PCI_IRQ_MSI        1
+#define PCI_IRQ_MSIX       2
+
+struct pci_device {
+    uint8_t bus;
+    uint8_t slot;
+    uint8_t func;
+    uint16_t vendor;
+    uint16_t device;
+    uint8_t class_code;
+    uint8_t subclass;
+    uint8_t prog_if;
+    uint8_t header_type;
+    uint8_t irq_line;
+    uint8_t irq_pin;
+    uint8_t secondary_bus;          // nur Bridges
+
+    // BARs mit Größe, beim 64-Bit-BAR bleibt der obere Eintrag leer
+    uint32_t bar[6];
+    uint32_t bar_size[6];
+    uint8_t bar_flags[6];           // PCI_BAR_*
+
+    // Interrupts
+    uint8_t irq_mode;               // PCI_IRQ_*
+    uint8_t irq_vector;             // erster MSI/MSI-X Vektor
+    uint8_t irq_count;
+    uint8_t msi_cap;                // 0 = nicht vorhanden
+    uint8_t msix_cap;
+    uint8_t pcie_cap;
+    volatile uint32_t* msix_table;
+    irq_handler_t irq_handler;
+    void* irq_ctx;
+};
+
 // Funktionen
-void pci_init(void);  // bleibt für init
-void pci_scan_and_print(void);  // NEU: nur scannen und ausgeben
-uint32_t pci_config_read(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset);
+// Einmalige Enumeration aller Busse (Bridges rekursiv) in die Gerätetabelle
+void pci_init(void);
+// Gerätetabelle ausgeben ('pci')
+void pci_scan_and_print(void);
+
+// Gerätetabelle
+int pci_device_count(void);
+struct pci_device* pci_device_at(int index);
+// 0xFF = beliebig, index = n-ter Treffer
+struct pci_device* pci_find_class(uint8_t class_code, uint8_t subclass, uint8_t prog_if, int index);
+struct pci_device* pci_find_device(uint16_t vendor, uint16_t device, int index);
+
+// offset bis 0xFFF mit ECAM, sonst bis 0xFF
+uint32_t pci_config_read(uint8_t bus, uint8_t slot, uint8_t func, uint16_t offset);
+void pci_config_write(uint8_t bus, uint8_t slot, uint8_t func, uint16_t offset, uint32_t value);
+int pci_ecam_enabled(void);
 int pci_device_exists(uint8_t bus, uint8_t slot, uint8_t func);
 
+// Header einlesen, 0 wenn dort kein Gerät antwortet
+int pci_get_device(uint8_t bus, uint8_t slot, uint8_t func, struct pci_device* dev);
+
+// Zugriffe auf den Konfigurationsraum eines Geräts (beliebig ausgerichtet)
+uint32_t pci_read32(struct pci_device* dev, uint16_t offset);
+uint16_t pci_read16(struct pci_device* dev, uint16_t offset);
+uint8_t pci_read8(struct pci_device* dev, uint16_t offset);
+void pci_write32(struct pci_device* dev, uint16_t offset, uint32_t value);
+void pci_write16(struct pci_device* dev, uint16_t offset, uint16_t value);
+
+// Capability-Liste ablaufen, Rückgabe Offset oder 0
+uint8_t pci_find_capability(struct pci_device* dev, uint8_t cap_id);
+// Extended Capability (PCIe, ab 0x100) - nur mit ECAM, sonst 0
+uint16_t pci_find_ext_capability(struct pci_device* dev, uint16_t cap_id);
+
+// Physische Adresse eines Memory-BARs aus der Tabelle (64-Bit BARs: nur
+// unterhalb 4 GB), 0 = keiner
+uint32_t pci_bar_address(struct pci_device* dev, int bar);
+
+// ========================
+// MSI / MSI-X (msi.c)
+// ========================
+// Bis zu nvec eigene, flankengesteuerte Vektoren (MSI-X bevorzugt, sonst MSI),
+// handler(ctx) wird auf jedem registriert. Rückgabe Anzahl, 0 = bei INTx bleiben
+// (kein APIC, keine Capability). Der erste Vektor steht in dev->irq_vector.
+int pci_enable_msi(struct pci_device* dev, int nvec, irq_handler_t handler, void* ctx);
+void pci_disable_msi(struct pci_device* dev);
+
+// Einzelnen Vektor (0 .. irq_count-1) sperren / freigeben
+void pci_msi_mask(struct pci_device* dev, int index);
+void pci_msi_unmask(struct pci_device* dev, int index);
+
 #endif
@@ -40,3 +40,31 @@ void pic_send_eoi(unsigned char irq) {
     }
     outb(0x20, 0x20);
 }
+
+// In-Service-Register beider PICs (OCW3), Slave in den oberen 8 Bit
+unsigned short pic_get_isr(void) {
+    outb(0x20, 0x0B);
+    outb(0xA0, 0x0B);
+    return (inb(0xA0) << 8) | inb(0x20);
+}
+
+// IRQ7/15 ohne gesetztes ISR-Bit kommt nicht von einem Gerät. Beim Slave hat
+// der Master die Kaskade trotzdem bedient und braucht sein EOI.
+int pic_spurious(unsigned char irq) {
+    if (irq != 7 && irq != 15) return 0;
+    if (pic_get_isr() & (1 << irq)) return 0;
+    if (irq == 15) outb(0x20, 0x20);
+    return 1;
+}
+
+// Einzelne IRQ-Leitung sperren / freigeben (Master 0-7, Slave 8-15)
+void pic_mask(unsigned char irq) {
+    unsigned short port = irq < 8 ? 0x21 : 0xA1;
+    outb(port, inb(port) | (1 << (irq & 7)));
+}
+
+void pic_unmask(unsigned char irq) {
+    unsigned short port = irq < 8 ? 0x21 : 0xA1;
+    outb(port, inb(port) & ~(1 << (irq & 7)));
+    if(irq >= 8) outb(0x21, inb(0x21) & ~0x04);    // Kaskade (IRQ2) mit freigeben
+}
@@ -4,5 +4,9 @@
 
 void pic_remap(int offset1, int offset2);
 void pic_send_eoi(unsigned char irq);
+void pic_mask(unsigned char irq);
+void pic_unmask(unsigned char irq);
+unsigned short pic_get_isr(void);
+int pic_spurious(unsigned char irq);
 
 #endif
@@ -1,30 +1,208 @@
 // kernel/drivers/screen.c
 #include "screen.h"
+#include "serial.h"
+#include "fbcon.h"
 #include "../lib/utils.h"
+#include "../lib/mem.h"
+#include "../lib/bitmap.h"
+#include "../memory/heap.h"
 
 // Globale Variablen
 int cursor_x = 0;
 int cursor_y = 0;
 
+// -----------------------------------------------------------------
+// SHADOW BUFFER
+// -----------------------------------------------------------------
+// Alle Ausgaben landen zuerst im RAM. screen_flush() kopiert nur geänderte
+// Zeilen in den (Write-Combining) VGA-Speicher - gelesen wird dort nie.
+// Zeile 0 (Status/Uhr) ist fest, die Zeilen 1-24 sind die letzten Zeilen
+// eines Rings: Scrollen verschiebt nur ring_top (O(1)), was oben
+// herausfällt, bleibt als Scrollback erhalten.
+
+#define RING_ROWS (SCREEN_HEIGHT - 1)
+#define ALL_RING_LINES (((1u << SCREEN_HEIGHT) - 1) & ~1u)
+
+typedef uint16_t screen_line_t[SCREEN_WIDTH];
+
+static uint16_t status_line[SCREEN_WIDTH];
+static screen_line_t boot_lines[RING_ROWS];     // bis der Heap steht
+static screen_line_t* ring = boot_lines;
+static int ring_size = RING_ROWS;
+
+static int ring_top = 0;                    // Ringzeile von logischer Zeile 1
+static int history_lines = 0;               // gültige Zeilen vor ring_top
+static int view_offset = 0;                 // 0 = live, sonst Zeilen zurück
+static volatile uint32_t dirty_lines = 0;   // Bit y = Bildschirmzeile y neu zeichnen
+static uint16_t hw_cursor = 0xFFFF;         // zuletzt an den CRTC geschrieben
+static int pending_scroll = 0;              // Live-Scrolls seit dem letzten Flush (fbcon)
+static volatile int flushing = 0;
+
+// Statistik
+static uint32_t scroll_count = 0;
+static uint32_t flush_count = 0;
+static uint32_t lines_flushed = 0;
+
+static inline int ring_index(int index) {
+    if (index >= ring_size) index -= ring_size;
+    if (index < 0) index += ring_size;
+    return index;
+}
+
+// Schreibziel: logische (live) Zeile y
+static inline uint16_t* shadow_row(int y) {
+    if (y == 0) return status_line;
+    return ring[ring_index(ring_top + y - 1)];
+}
+
+// Anzeige: Bildschirmzeile y unter Berücksichtigung des Scrollback-Fensters
+static inline uint16_t* display_row(int y) {
+    if (y == 0) return status_line;
+    return ring[ring_index(ring_top + y - 1 - view_offset)];
+}
+
+// Live-Zeile y geändert - sichtbar nur, wenn sie im Fenster liegt
+static inline void mark_dirty(int y) {
+    if (y == 0) {
+        dirty_lines |= 1u;
+    } else if (y + view_offset < SCREEN_HEIGHT) {
+        dirty_lines |= 1u << (y + view_offset);
+    }
+}
+
+static inline uint16_t make_cell(char c, unsigned char color) {
+    return (uint16_t)((color << 8) | (unsigned char)c);
+}
+
+// Framebuffer: Zeilen rendern statt kopieren, Scrollen als Block-Verschiebung
+static void flush_fbcon(uint32_t mask) {
+    if (pending_scroll > 0 && pending_scroll < RING_ROWS) {
+        fbcon_scroll(1, RING_ROWS, pending_scroll);
+    }
+    pending_scroll = 0;
+
+    while (mask) {
+        int y = bit_scan_forward(mask);
+        fbcon_draw_line(y, display_row(y));
+        lines_flushed++;
+        mask &= mask - 1;
+    }
+
+    if (view_offset > 0) fbcon_cursor(-1, 0);
+    else fbcon_cursor(cursor_x, cursor_y);
+    fbcon_present();
+}
+
+void screen_flush(void) {
+    // Ein IRQ-Flush mitten in einem Flush: der nächste holt es nach
+    if (flushing) return;
+    flushing = 1;
+
+    // Maske atomar abholen - ein IRQ darf währenddessen neue Zeilen markieren
+    uint32_t mask;
+    asm volatile("xchgl %0, %1" : "=r"(mask), "+m"(dirty_lines) : "0"(0) : "memory");
+    if (mask) flush_count++;
+
+    if (fbcon_active()) {
+        flush_fbcon(mask);
+        flushing = 0;
+        return;
+    }
+
+    uint16_t* vga = (uint16_t*)VIDEO_MEMORY;
+
+    while (mask) {
+        int y = bit_scan_forward(mask);
+        uint16_t* src = display_row(y);
+
+        // Zeilen, die auch im Ring hintereinander liegen, in einem Rutsch
+        int n = 1;
+        while (y + n < SCREEN_HEIGHT && ((mask >> (y + n)) & 1) &&
+               display_row(y + n) == src + n * SCREEN_WIDTH) {
+            n++;
+        }
+
+        memcpy(vga + y * SCREEN_WIDTH, src, n * SCREEN_WIDTH * 2);
+        lines_flushed += n;
+        mask &= ~(((1u << n) - 1) << y);
+    }
+
+    // Hardware-Cursor: vier outb nur, wenn er sich bewegt hat
+    int x = cursor_x < SCREEN_WIDTH ? cursor_x : SCREEN_WIDTH - 1;
+    int y = cursor_y < SCREEN_HEIGHT ? cursor_y : SCREEN_HEIGHT - 1;
+    uint16_t position = (uint16_t)(y * SCREEN_WIDTH + x);
+    if (view_offset > 0) position = SCREEN_WIDTH * SCREEN_HEIGHT;  // versteckt
+    if (position != hw_cursor) {
+        outb(0x3D4, 0x0F);
+        outb(0x3D5, (unsigned char)(position & 0xFF));
+        outb(0x3D4, 0x0E);
+        outb(0x3D5, (unsigned char)((position >> 8) & 0xFF));
+        hw_cursor = position;
+    }
+    flushing = 0;
+}
+
+void screen_stats(uint32_t* scrolls, uint32_t* flushes, uint32_t* lines) {
+    *scrolls = scroll_count;
+    *flushes = flush_count;
+    *lines = lines_flushed;
+}
+
+// -----------------------------------------------------------------
+// SCROLLBACK
+// -----------------------------------------------------------------
+
+// Nach init_heap: großen Ring anlegen, bisherige Zeilen übernehmen
+void screen_scrollback_init(void) {
+    screen_line_t* lines = (screen_line_t*)kmalloc_safe(SCROLLBACK_LINES * sizeof(screen_line_t));
+    if (!lines) return;
+
+    for (int y = 1; y < SCREEN_HEIGHT; y++) {
+        memcpy(lines[y - 1], shadow_row(y), sizeof(screen_line_t));
+    }
+
+    ring = lines;
+    ring_size = SCROLLBACK_LINES;
+    ring_top = 0;
+    history_lines = 0;
+    view_offset = 0;
+}
+
+// lines > 0: zurück in die Historie, lines < 0: wieder Richtung live
+void screen_scroll_view(int lines) {
+    int offset = view_offset + lines;
+    if (offset > history_lines) offset = history_lines;
+    if (offset < 0) offset = 0;
+    if (offset == view_offset) return;
+
+    view_offset = offset;
+    pending_scroll = 0;
+    dirty_lines |= ALL_RING_LINES;
+}
+
+// Alles neu zeichnen (z.B. nach dem Wechsel in den Framebuffer)
+void screen_redraw(void) {
+    dirty_lines |= ALL_RING_LINES | 1u;
+}
+
+int screen_view_offset(void) {
+    return view_offset;
+}
+
 // -----------------------------------------------------------------
 // BASICS
 // -----------------------------------------------------------------
 
 void print_char_color(char c, int x, int y, unsigned char color) {
-    unsigned short* buffer = (unsigned short*)VIDEO_MEMORY;
-    int position = y * SCREEN_WIDTH + x;
-    buffer[position] = (color << 8) | c;
+    if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return;
+    shadow_row(y)[x] = make_cell(c, color);
+    mark_dirty(y);
 }
 
+// Nur merken - der CRTC wird beim nächsten screen_flush() gesetzt
 void set_cursor(int x, int y) {
     cursor_x = x;
     cursor_y = y;
-
-    unsigned short position = (y * SCREEN_WIDTH) + x;
-    outb(0x3D4, 0x0F);
-    outb(0x3D5, (unsigned char)(position & 0xFF));
-    outb(0x3D4, 0x0E);
-    outb(0x3D5, (unsigned char)((position >> 8) & 0xFF));
 }
 
 void get_cursor(int* x, int* y) {
@@ -32,28 +210,48 @@ void get_cursor(int* x, int* y) {
     *y = cursor_y;
 }
 
+// Zeilenumbruch am unteren Rand: Ring weiterdrehen
+static void newline(void) {
+    cursor_x = 0;
+    cursor_y++;
+    if (cursor_y >= SCREEN_HEIGHT) {
+        scroll_screen();
+        cursor_y = SCREEN_HEIGHT - 1;
+    }
+}
+
 // -----------------------------------------------------------------
 // KPRINT
 // -----------------------------------------------------------------
 
-void kprint(const char* str, unsigned char color) {
-    for (int i = 0; str[i] != '\0'; i++) {
+// len Zeichen ausgeben (kprintf schreibt Abschnitte ohne '\0')
+void kwrite(const char* str, int len, unsigned char color) {
+    // Konsole auf COM1 spiegeln (gepuffert, sendet per IRQ). Nur der
+    // Textfluss - die Statuszeile (Zeile 0) und alles über kprint_at,
+    // kprint_no_scroll oder print_char_color bleibt auf dem Bildschirm,
+    // sonst landen Uhr-Fragmente mitten in Log- und Benchmark-Zeilen.
+    if (cursor_y > 0) serial_write(str, len);
+
+    for (int i = 0; i < len; i++) {
         char c = str[i];
 
         if (c == '\n') {
-            cursor_x = 0;
-            cursor_y++;
+            newline();
         } else {
             print_char_color(c, cursor_x, cursor_y, color);
             cursor_x++;
 
             if (cursor_x >= SCREEN_WIDTH) {
-                cursor_x = 0;
-                cursor_y++;
+                newline();
             }
         }
     }
-    set_cursor(cursor_x, cursor_y);
+}
+
+void kprint(const char* str, unsigned char color) {
+    int len = 0;
+    while (str[len]) len++;
+    kwrite(str, len, color);
 }
 
 void kprint_no_scroll(const char* str, unsigned char color) {
@@ -84,20 +282,23 @@ void kprint_no_scroll(const char* str, unsigned char color) {
 
     cursor_x = saved_x;
     cursor_y = saved_y;
-    set_cursor(cursor_x, cursor_y);
 }
 
+// Feste Position, ohne cursor_x/cursor_y anzufassen - darf deshalb auch
+// aus Deferred Work mitten in eine andere Ausgabe hinein schreiben
 void kprint_at(const char* str, int x, int y, unsigned char color) {
-    int saved_x = cursor_x;
-    int saved_y = cursor_y;
-
-    cursor_x = x;
-    cursor_y = y;
-    kprint_no_scroll(str, color);
-
-    cursor_x = saved_x;
-    cursor_y = saved_y;
-    set_cursor(cursor_x, cursor_y);
+    for (int i = 0; str[i] != '\0' && y < SCREEN_HEIGHT; i++) {
+        if (str[i] == '\n') {
+            x = 0;
+            y++;
+            continue;
+        }
+        print_char_color(str[i], x, y, color);
+        if (++x >= SCREEN_WIDTH) {
+            x = 0;
+            y++;
+        }
+    }
 }
 
 // -----------------------------------------------------------------
@@ -105,38 +306,46 @@ void kprint_at(const char* str, int x, int y, unsigned char color) {
 // -----------------------------------------------------------------
 
 void scroll_screen(void) {
-    unsigned short* buffer = (unsigned short*)VIDEO_MEMORY;
-
-    for (int y = 0; y < SCREEN_HEIGHT - 1; y++) {
-        for (int x = 0; x < SCREEN_WIDTH; x++) {
-            buffer[y * SCREEN_WIDTH + x] = buffer[(y + 1) * SCREEN_WIDTH + x];
-        }
-    }
+    // Oberste Live-Zeile wandert in die Historie, die älteste fällt heraus
+    ring_top = ring_index(ring_top + 1);
+    if (history_lines < ring_size - RING_ROWS) history_lines++;
 
     unsigned short clear_char = (COLOR_DARK_GRAY << 4) | COLOR_WHITE;
     clear_char = (clear_char << 8) | ' ';
-
-    for (int x = 0; x < SCREEN_WIDTH; x++) {
-        buffer[(SCREEN_HEIGHT - 1) * SCREEN_WIDTH + x] = clear_char;
+    memsetw(shadow_row(SCREEN_HEIGHT - 1), clear_char, SCREEN_WIDTH);
+
+    // Im Scrollback bleibt das Fenster stehen (außer am Ende der Historie),
+    // live hat sich im VGA-Speicher jede Ringzeile verschoben
+    if (view_offset > 0 && view_offset < history_lines) {
+        view_offset++;
+    } else {
+        if (view_offset == 0) pending_scroll++;
+        dirty_lines |= ALL_RING_LINES;
     }
+    scroll_count++;
 }
 
 void clear_screen(unsigned char bg_color) {
     unsigned char color = (bg_color << 4) | COLOR_WHITE;
+    uint16_t blank = make_cell(' ', color);
 
+    // Sichtbaren Inhalt in die Historie schieben, dann leere Zeilen
+    if (ring_size > RING_ROWS) {
+        ring_top = ring_index(ring_top + RING_ROWS);
+        history_lines += RING_ROWS;
+        if (history_lines > ring_size - RING_ROWS) history_lines = ring_size - RING_ROWS;
+    }
     for (int y = 1; y < SCREEN_HEIGHT; y++) {
-        for (int x = 0; x < SCREEN_WIDTH; x++) {
-            print_char_color(' ', x, y, color);
-        }
+        memsetw(shadow_row(y), blank, SCREEN_WIDTH);
     }
+    memsetw(status_line, blank, 68);
 
-    for (int x = 0; x < 68; x++) {
-        print_char_color(' ', x, 0, color);
-    }
+    view_offset = 0;
+    pending_scroll = 0;
+    dirty_lines |= ALL_RING_LINES | 1u;
 
     cursor_x = 0;
     cursor_y = 1;
-    set_cursor(cursor_x, cursor_y);
 }
 
 // -----------------------------------------------------------------
@@ -144,6 +353,8 @@ void clear_screen(unsigned char bg_color) {
 // -----------------------------------------------------------------
 
 void delay_ms(int milliseconds) {
+    // Wer wartet, soll das bisher Ausgegebene sehen
+    screen_flush();
     for(int i = 0; i < milliseconds * 1000; i++) {
         asm volatile("nop");
     }
@@ -2,12 +2,16 @@
 #ifndef KERNEL_DRIVERS_SCREEN_H
 #define KERNEL_DRIVERS_SCREEN_H
 
+#include <stdint.h>
+
 // ========================
 // BILDSCHIRM KONSTANTEN
 // ========================
 #define SCREEN_WIDTH 80
 #define SCREEN_HEIGHT 25
 #define VIDEO_MEMORY 0xB8000
+#define VIDEO_MEMORY_SIZE 0x8000    // Textmodus-Fenster 0xB8000 - 0xBFFFF
+#define SCROLLBACK_LINES 10000      // Ring im Heap (80 Zellen = 160 Bytes pro Zeile)
 
 // ========================
 // BASIS FARBEN
@@ -98,6 +102,7 @@
 // ========================
 void print_char_color(char c, int x, int y, unsigned char color);
 void kprint(const char* str, unsigned char color);
+void kwrite(const char* str, int len, unsigned char color);
 void kprint_at(const char* str, int x, int y, unsigned char color);
 void kprint_no_scroll(const char* str, unsigned char color);
 void scroll_screen(void);
@@ -106,6 +111,16 @@ void set_cursor(int x, int y);
 void get_cursor(int* x, int* y);
 void show_ascii_boot(void);
 
+// Shadow Buffer -> VGA (nur geänderte Zeilen, Cursor einmal)
+void screen_flush(void);
+void screen_stats(uint32_t* scrolls, uint32_t* flushes, uint32_t* lines);
+
+// Scrollback (Shift+PgUp/PgDn)
+void screen_scrollback_init(void);
+void screen_scroll_view(int lines);
+int screen_view_offset(void);
+void screen_redraw(void);
+
 // ========================
 // GLOBALE VARIABLEN
 // ========================
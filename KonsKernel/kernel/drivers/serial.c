@@ -0,0 +1,133 @@
+// kernel/drivers/serial.c - COM1 16550 mit FIFO, Senden per THRE-Interrupt
+#include "serial.h"
+#include "screen.h"
+#include "../cpu/cpu.h"
+#include "../memory/idt.h"
+#include "../lib/utils.h"
+#include "../lib/printf.h"
+
+static char tx_ring[SERIAL_TX_RING];
+static volatile uint32_t tx_head = 0;      // schreibt serial_write
+static volatile uint32_t tx_tail = 0;      // liest tx_fill
+static volatile int tx_active = 0;         // THRE-Interrupt eingeschaltet
+static int present = 0;
+
+// Statistik
+static uint32_t tx_bytes = 0;
+static uint32_t tx_irqs = 0;
+static uint32_t tx_polled = 0;
+
+int serial_present(void) {
+    return present;
+}
+
+// FIFO ist leer (THRE) - bis zu 16 Bytes am Stück nachlegen.
+// Nur mit gesperrten Interrupts oder aus dem IRQ aufrufen.
+static void tx_fill(void) {
+    for(int i = 0; i < SERIAL_FIFO && tx_tail != tx_head; i++) {
+        outb(SERIAL_COM1 + UART_DATA, tx_ring[tx_tail & (SERIAL_TX_RING - 1)]);
+        tx_tail++;
+    }
+}
+
+// Ring voll oder Flush: warten, bis der FIFO leer ist, und direkt nachfüllen
+static void tx_poll(void) {
+    while(!(inb(SERIAL_COM1 + UART_LSR) & UART_LSR_THRE)) { }
+    tx_fill();
+    tx_polled++;
+}
+
+static int serial_irq(void* ctx) {
+    uint8_t iir = inb(SERIAL_COM1 + UART_IIR);  // Lesen quittiert THRE
+    if(iir & UART_IIR_NONE) return IRQ_NONE;
+
+    if((iir & UART_IIR_MASK) == UART_IIR_THRE) {
+        tx_irqs++;
+        if(tx_tail == tx_head) {
+            // Nichts mehr da: Interrupt aus, der nächste Schreiber startet neu
+            outb(SERIAL_COM1 + UART_IER, 0);
+            tx_active = 0;
+        } else {
+            tx_fill();
+        }
+    }
+    return IRQ_HANDLED;
+}
+
+void serial_init(void) {
+    uint16_t divisor = 115200 / SERIAL_BAUD;
+
+    outb(SERIAL_COM1 + UART_IER, 0x00);             // Interrupts aus
+    outb(SERIAL_COM1 + UART_LCR, 0x80);             // DLAB
+    outb(SERIAL_COM1 + UART_DATA, divisor & 0xFF);
+    outb(SERIAL_COM1 + UART_IER, divisor >> 8);
+    outb(SERIAL_COM1 + UART_LCR, 0x03);             // 8N1
+    outb(SERIAL_COM1 + UART_FCR, 0xC7);             // FIFO an, leeren, 14 Byte RX-Schwelle
+
+    // Loopback-Test: ohne UART kommt nichts zurück
+    outb(SERIAL_COM1 + UART_MCR, 0x1E);
+    outb(SERIAL_COM1 + UART_DATA, 0xAE);
+    if(inb(SERIAL_COM1 + UART_DATA) != 0xAE) {
+        present = 0;
+        return;
+    }
+
+    // DTR, RTS, OUT2 (OUT2 schaltet die IRQ-Leitung durch)
+    outb(SERIAL_COM1 + UART_MCR, 0x0B);
+    present = 1;
+
+    irq_register(IRQ_BASE + SERIAL_IRQ, "serial", serial_irq, 0);
+    irq_unmask(SERIAL_IRQ);
+}
+
+static void tx_kick(void) {
+    if(tx_active) return;
+    if(inb(SERIAL_COM1 + UART_LSR) & UART_LSR_THRE) tx_fill();
+    tx_active = 1;
+    outb(SERIAL_COM1 + UART_IER, UART_IER_THRE);
+}
+
+static void tx_put(char c) {
+    if(tx_head - tx_tail >= SERIAL_TX_RING) tx_poll();
+    tx_ring[tx_head & (SERIAL_TX_RING - 1)] = c;
+    tx_head++;
+}
+
+void serial_write(const char* str, int len) {
+    if(!present || len <= 0) return;
+
+    // Auch aus Exception-Handlern aufrufbar - daher kurz sperren statt SPSC
+    uint32_t flags = irq_save();
+    for(int i = 0; i < len; i++) {
+        if(str[i] == '\n') tx_put('\r');
+        tx_put(str[i]);
+    }
+    tx_bytes += len;
+    tx_kick();
+    irq_restore(flags);
+}
+
+void serial_print(const char* str) {
+    int len = 0;
+    while(str[len]) len++;
+    serial_write(str, len);
+}
+
+void serial_flush(void) {
+    if(!present) return;
+
+    uint32_t flags = irq_save();
+    while(tx_tail != tx_head) tx_poll();
+    irq_restore(flags);
+}
+
+void serial_print_info(void) {
+    if(!present) {
+        kprint("Serial:   not present\n", TXT_GRAY);
+        return;
+    }
+    kprintf(TXT_NORMAL, "Serial:   %CCOM1 %u baud, %u byte FIFO%C\n",
+            TXT_INFO, SERIAL_BAUD, SERIAL_FIFO, TXT_NORMAL);
+    kprintf(TXT_NORMAL, "          %u bytes sent, %u THRE irqs, %u polled, %u queued\n",
+            tx_bytes, tx_irqs, tx_polled, tx_head - tx_tail);
+}
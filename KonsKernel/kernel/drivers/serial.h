@@ -0,0 +1,45 @@
+// kernel/drivers/serial.h
+#ifndef KERNEL_DRIVERS_SERIAL_H
+#define KERNEL_DRIVERS_SERIAL_H
+
+#include <stdint.h>
+
+// ========================
+// 16550 UART (COM1)
+// ========================
+#define SERIAL_COM1     0x3F8
+#define SERIAL_IRQ      4
+#define SERIAL_BAUD     115200
+#define SERIAL_FIFO     16          // Bytes pro THRE-Interrupt
+#define SERIAL_TX_RING  8192        // Zweierpotenz
+
+// Register (Offset zur Basis)
+#define UART_DATA       0           // THR/RBR, bei DLAB=1 Divisor low
+#define UART_IER        1           // bei DLAB=1 Divisor high
+#define UART_IIR        2           // lesen
+#define UART_FCR        2           // schreiben
+#define UART_LCR        3
+#define UART_MCR        4
+#define UART_LSR        5
+
+#define UART_IER_THRE   0x02
+#define UART_LSR_THRE   0x20
+#define UART_IIR_NONE   0x01
+#define UART_IIR_MASK   0x0E
+#define UART_IIR_THRE   0x02
+
+// Port prüfen, FIFO an, IRQ4 registrieren - nach isr_install aufrufen
+void serial_init(void);
+int serial_present(void);
+
+// Bytes in den TX-Ring legen ('\n' wird zu "\r\n"), sendet der THRE-Interrupt.
+// Ist der Ring voll, wird direkt in den FIFO gepollt statt Daten zu verwerfen.
+void serial_write(const char* str, int len);
+void serial_print(const char* str);
+
+// Alles Gepufferte synchron rausschieben (vor Halt / Reboot)
+void serial_flush(void);
+
+void serial_print_info(void);
+
+#endif
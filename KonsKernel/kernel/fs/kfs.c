@@ -3,6 +3,10 @@
 #include "kfs.h"
 #include "../drivers/screen.h"
 #include "../lib/string.h"
+#include "../lib/bitmap.h"
+#include "../lib/mem.h"
+#include "../lib/printf.h"
+#include "../lib/log.h"
 #include <stddef.h>
 
 // RAM-Disk
@@ -15,14 +19,14 @@ uint8_t* block_bitmap = (uint8_t*)(ramdisk + BLOCK_SIZE + (MAX_FILES * sizeof(st
 uint8_t* data_blocks = ramdisk + (BLOCK_SIZE * 10);
 uint32_t current_dir_inode = 1;
 
+// Next-Fit: Suche beginnt hinter dem zuletzt vergebenen Block
+static uint32_t block_hint = 0;
+
 void kfs_init(void) {
     if(superblock->magic != KFS_MAGIC) {
         kfs_format("KonsKernelFS");
     } else {
-        kprint("[OK]\n", COLOR_GREEN_ON_BLUE);
-        kprint("Volume: ", COLOR_WHITE_ON_BLUE);
-        kprint(superblock->volume_name, COLOR_CYAN_ON_BLUE);
-        kprint("\n", COLOR_WHITE_ON_BLUE);
+        klog(LOG_INFO, "KFS: volume %s mounted", superblock->volume_name);
     }
     current_dir_inode = 1;
 }
@@ -56,18 +60,11 @@ void kfs_format(const char* volume_name) {
         }
     }
 
-    uint32_t bitmap_size = superblock->total_blocks / 8;
-    for(i = 0; i < bitmap_size; i++) {
-        block_bitmap[i] = 0xFF;
-    }
-
     uint32_t meta_blocks = 10;
-    for(i = 0; i < meta_blocks; i++) {
-        int byte = i / 8;
-        int bit = i % 8;
-        block_bitmap[byte] &= ~(1 << bit);
-        superblock->free_blocks--;
-    }
+    bitmap_set_range((uint32_t*)block_bitmap, 0, superblock->total_blocks);
+    bitmap_clear_range((uint32_t*)block_bitmap, 0, meta_blocks);
+    superblock->free_blocks -= meta_blocks;
+    block_hint = meta_blocks;
 
     inode_table[1].id = 1;
     inode_table[1].type = 2;
@@ -78,65 +75,25 @@ void kfs_format(const char* volume_name) {
     inode_table[1].name[1] = '\0';
 
     kprint("\nKFS formatted successfully!\n", COLOR_GREEN_ON_BLUE);
-    kprint("Total blocks: ", COLOR_WHITE_ON_BLUE);
-
-    char blocks_str[16];
-    char* ptr = blocks_str;
-    uint32_t n = superblock->total_blocks;
-    if(n == 0) *ptr++ = '0';
-    else {
-        char temp[16];
-        int j = 0;
-        while(n > 0) { temp[j++] = '0' + (n % 10); n /= 10; }
-        while(j > 0) *ptr++ = temp[--j];
-    }
-    *ptr = '\0';
-    kprint(blocks_str, COLOR_CYAN_ON_BLUE);
-    kprint(" (", COLOR_WHITE_ON_BLUE);
-
-    ptr = blocks_str;
-    n = superblock->free_blocks;
-    if(n == 0) *ptr++ = '0';
-    else {
-        char temp[16];
-        int j = 0;
-        while(n > 0) { temp[j++] = '0' + (n % 10); n /= 10; }
-        while(j > 0) *ptr++ = temp[--j];
-    }
-    *ptr++ = ' ';
-    *ptr++ = 'f';
-    *ptr++ = 'r';
-    *ptr++ = 'e';
-    *ptr++ = 'e';
-    *ptr = '\0';
-
-    kprint(blocks_str, COLOR_GREEN_ON_BLUE);
-    kprint(")\n", COLOR_WHITE_ON_BLUE);
+    kprintf(COLOR_WHITE_ON_BLUE, "Total blocks: %C%u%C (%C%u free%C)\n",
+            COLOR_CYAN_ON_BLUE, superblock->total_blocks, COLOR_WHITE_ON_BLUE,
+            COLOR_GREEN_ON_BLUE, superblock->free_blocks, COLOR_WHITE_ON_BLUE);
 }
 
 int find_free_block(void) {
-    uint32_t total_blocks = superblock->total_blocks;
-
-    for(uint32_t i = 0; i < total_blocks; i++) {
-        int byte = i / 8;
-        int bit = i % 8;
+    int block = bitmap_find_next_fit((uint32_t*)block_bitmap, superblock->total_blocks, &block_hint);
+    if(block == -1) return -1;
 
-        if(block_bitmap[byte] & (1 << bit)) {
-            block_bitmap[byte] &= ~(1 << bit);
-            superblock->free_blocks--;
-            return i;
-        }
-    }
-    return -1;
+    bitmap_clear((uint32_t*)block_bitmap, block);
+    superblock->free_blocks--;
+    return block;
 }
 
 void free_block(int block_idx) {
-    if(block_idx < 0) return;
+    if(block_idx < 0 || block_idx >= superblock->total_blocks) return;
+    if(bitmap_test((uint32_t*)block_bitmap, block_idx)) return;  // Schon frei
 
-    int byte = block_idx / 8;
-    int bit = block_idx % 8;
-
-    block_bitmap[byte] |= (1 << bit);
+    bitmap_set((uint32_t*)block_bitmap, block_idx);
     superblock->free_blocks++;
 }
 
@@ -259,10 +216,7 @@ int kfs_write(int inode_idx, const void* data, uint32_t size) {
         uint32_t to_copy = size - written;
         if(to_copy > BLOCK_SIZE) to_copy = BLOCK_SIZE;
 
-        uint8_t* dst = data_blocks + (block * BLOCK_SIZE);
-        for(uint32_t j = 0; j < to_copy; j++) {
-            dst[j] = src[written + j];
-        }
+        memcpy(data_blocks + (block * BLOCK_SIZE), src + written, to_copy);
 
         written += to_copy;
     }
@@ -291,9 +245,7 @@ int kfs_read(int inode_idx, void* buffer, uint32_t size) {
         uint32_t to_read = size - read;
         if(to_read > BLOCK_SIZE) to_read = BLOCK_SIZE;
 
-        for(uint32_t j = 0; j < to_read; j++) {
-            dst[read + j] = src[j];
-        }
+        memcpy(dst + read, src, to_read);
 
         read += to_read;
     }
@@ -12,15 +12,27 @@
 #include "memory/isr.h"
 #include "memory/heap.h"
 #include "memory/idt.h"
+#include "memory/paging.h"
+
+// ========================
+// CPU
+// ========================
+#include "cpu/cpu.h"
+#include "cpu/fpu.h"
+#include "cpu/work.h"
 
 // ========================
 // DRIVERS
 // ========================
 #include "drivers/pic.h"
+#include "drivers/apic.h"
+#include "drivers/acpi.h"
 #include "drivers/screen.h"
 #include "drivers/keyboard.h"
 #include "drivers/pci.h"
 #include "drivers/ahci.h"
+#include "drivers/serial.h"
+#include "drivers/fbcon.h"
 #include"drivers/mouse.h"
 
 // ========================
@@ -39,6 +51,9 @@
 // ========================
 #include "lib/string.h"
 #include "lib/utils.h"
+#include "lib/mem.h"
+#include "lib/printf.h"
+#include "lib/log.h"
 
 // ========================
 // GUI
@@ -51,8 +66,11 @@
 __attribute__((section(".multiboot")))
 const unsigned int multiboot_header[] = {
     0x1BADB002,           // Magic number
-    0x00000003,           // Flags (align modules + memory map)
-    -(0x1BADB002 + 0x00000003)  // Checksum
+    0x00000007,           // Flags (align modules + memory map + video mode)
+    -(0x1BADB002 + 0x00000007),  // Checksum
+    0, 0, 0, 0, 0,        // Adressfelder (nur mit Flag 16)
+    0,                    // Linearer Framebuffer
+    1024, 768, 32         // Breite, Höhe, Farbtiefe
 };
 
 // ========================
@@ -92,6 +110,16 @@ extern unsigned char inb(unsigned short port);
 void kernel_main(unsigned int magic, unsigned int addr) {
     debug_mode = 0;
 
+    // CPU Features zuerst, dann SSE freischalten - mem* wählt danach den Kopierpfad
+    cpu_init();
+    klog_init();
+    fpu_init();
+    mem_init();
+    string_init();
+
+    // Hat der Bootloader einen Grafikmodus gesetzt, läuft die Konsole ab hier im LFB
+    if (fbcon_init((struct multiboot_info*)addr)) screen_redraw();
+
     // Boot
     show_ascii_boot();
     delay_ms(1000);
@@ -100,14 +128,22 @@ void kernel_main(unsigned int magic, unsigned int addr) {
     // Initialisierung - ALLES aus Modulen!
     read_multiboot_info(addr);
     init_heap();
+    paging_init();
+    fbcon_map();
+    screen_scrollback_init();
     gdt_install();
     kfs_init();
+    acpi_init();
     pic_remap(0x20, 0x28);
     isr_install();
+    apic_init();
     irq_install();
+    serial_init();
     pci_init();
     ahci_init();
 
+    // Boot-Meldungen aus dem Log-Ring auf die Konsole
+    klog_drain();
 
     // PIT Timer
     outb(0x43, 0x36);
@@ -118,6 +154,7 @@ void kernel_main(unsigned int magic, unsigned int addr) {
     while (inb(0x64) & 0x02) { }
     outb(0x64, 0xAE);
     while (inb(0x64) & 0x01) { inb(0x60); }
+    keyboard_init();
 
     // Interrupts aktivieren
     asm volatile("sti");
@@ -125,22 +162,7 @@ void kernel_main(unsigned int magic, unsigned int addr) {
     // Status anzeigen
     unsigned int total_mb = total_memory / (1024 * 1024);
     kprint_at("KonsKernel v1.4.0 loaded. ", 0, 7, TXT_SUCCESS);
-
-    char mem_str[16];
-    char* ptr = mem_str;
-    unsigned int n = total_mb;
-    if(n == 0) *ptr++ = '0';
-    else {
-        char temp[16];
-        int i = 0;
-        while(n > 0) { temp[i++] = '0' + (n % 10); n /= 10; }
-        while(i > 0) *ptr++ = temp[--i];
-    }
-    *ptr++ = 'M';
-    *ptr++ = 'B';
-    *ptr++ = ' ';
-    *ptr = '\0';
-    kprint(mem_str, TXT_CYAN);
+    kprintf(TXT_CYAN, "%uMB ", total_mb);
 
     // Shell starten
     kprint_at("kons> ", 0, 9, TXT_NORMAL);
@@ -157,6 +179,15 @@ void kernel_main(unsigned int magic, unsigned int addr) {
 
     // Hauptschleife
     while(1) {
-        asm volatile("hlt");
+        keyboard_poll();
+        work_run();
+        klog_drain();
+        screen_flush();
+
+        // Nur schlafen, wenn nichts ansteht: cli/Prüfen/sti;hlt, damit ein
+        // IRQ zwischen Prüfung und hlt nicht bis zum nächsten Tick liegen bleibt
+        asm volatile("cli");
+        if(keyboard_pending() || work_pending()) asm volatile("sti");
+        else asm volatile("sti; hlt");
     }
 }
@@ -29,6 +29,40 @@ struct multiboot_info {
     unsigned int config_table;
     unsigned int boot_loader_name;
     unsigned int apm_table;
+    unsigned int vbe_control_info;
+    unsigned int vbe_mode_info;
+    unsigned short vbe_mode;
+    unsigned short vbe_interface_seg;
+    unsigned short vbe_interface_off;
+    unsigned short vbe_interface_len;
+    unsigned long long framebuffer_addr;    // Bit 12 in flags
+    unsigned int framebuffer_pitch;
+    unsigned int framebuffer_width;
+    unsigned int framebuffer_height;
+    unsigned char framebuffer_bpp;
+    unsigned char framebuffer_type;         // 0 = Palette, 1 = RGB, 2 = EGA-Text
+    unsigned char color_info[6];            // RGB: Position/Größe von Rot, Grün, Blau
+} __attribute__((packed));
+
+#define MULTIBOOT_INFO_FRAMEBUFFER (1 << 12)
+#define MULTIBOOT_FRAMEBUFFER_RGB  1
+
+// Multiboot Memory Map Eintrag (mbi->mmap_addr)
+struct multiboot_mmap_entry {
+    unsigned int size;          // Größe OHNE dieses Feld
+    unsigned long long addr;
+    unsigned long long len;
+    unsigned int type;          // 1 = verfügbarer RAM
+} __attribute__((packed));
+
+#define MULTIBOOT_MEMORY_AVAILABLE 1
+
+// Multiboot Modul (mbi->mods_addr)
+struct multiboot_module {
+    unsigned int mod_start;
+    unsigned int mod_end;
+    unsigned int string;
+    unsigned int reserved;
 } __attribute__((packed));
 
 extern int debug_mode;
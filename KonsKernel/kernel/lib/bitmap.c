@@ -0,0 +1,105 @@
+// kernel/lib/bitmap.c
+#include "bitmap.h"
+
+// Maske für Bits [from, to) innerhalb eines Wortes (0 <= from < to <= 32)
+static inline uint32_t word_mask(uint32_t from, uint32_t to) {
+    uint32_t high = (to == BITMAP_WORD_BITS) ? 0xFFFFFFFF : ((1u << to) - 1);
+    return high & ~((1u << from) - 1);
+}
+
+// Popcount ohne libgcc (__builtin_popcount bräuchte __popcountsi2)
+static inline uint32_t popcount32(uint32_t v) {
+    v = v - ((v >> 1) & 0x55555555);
+    v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+    v = (v + (v >> 4)) & 0x0F0F0F0F;
+    return (v * 0x01010101) >> 24;
+}
+
+// === Bereich [start, start+count) setzen: Randwörter maskiert, Rest ganze Wörter ===
+void bitmap_set_range(uint32_t* map, uint32_t start, uint32_t count) {
+    uint32_t end = start + count;
+
+    while(start < end) {
+        uint32_t word = start / BITMAP_WORD_BITS;
+        uint32_t from = start % BITMAP_WORD_BITS;
+
+        if(from == 0 && end - start >= BITMAP_WORD_BITS) {
+            map[word] = 0xFFFFFFFF;
+            start += BITMAP_WORD_BITS;
+            continue;
+        }
+
+        uint32_t to = (end - word * BITMAP_WORD_BITS < BITMAP_WORD_BITS) ?
+                      end - word * BITMAP_WORD_BITS : BITMAP_WORD_BITS;
+        map[word] |= word_mask(from, to);
+        start = word * BITMAP_WORD_BITS + to;
+    }
+}
+
+void bitmap_clear_range(uint32_t* map, uint32_t start, uint32_t count) {
+    uint32_t end = start + count;
+
+    while(start < end) {
+        uint32_t word = start / BITMAP_WORD_BITS;
+        uint32_t from = start % BITMAP_WORD_BITS;
+
+        if(from == 0 && end - start >= BITMAP_WORD_BITS) {
+            map[word] = 0;
+            start += BITMAP_WORD_BITS;
+            continue;
+        }
+
+        uint32_t to = (end - word * BITMAP_WORD_BITS < BITMAP_WORD_BITS) ?
+                      end - word * BITMAP_WORD_BITS : BITMAP_WORD_BITS;
+        map[word] &= ~word_mask(from, to);
+        start = word * BITMAP_WORD_BITS + to;
+    }
+}
+
+// === Erstes gesetztes Bit ab 'start' finden (-1 = keins) ===
+// Leere Wörter werden in einem Vergleich übersprungen, im Treffer-Wort liefert bsf das Bit.
+int bitmap_find_next_set(const uint32_t* map, uint32_t nbits, uint32_t start) {
+    if(start >= nbits) return -1;
+
+    uint32_t word = start / BITMAP_WORD_BITS;
+    uint32_t words = BITMAP_WORDS(nbits);
+    uint32_t value = map[word] & ~((1u << (start % BITMAP_WORD_BITS)) - 1);
+
+    while(1) {
+        if(value) {
+            uint32_t bit = word * BITMAP_WORD_BITS + bit_scan_forward(value);
+            return (bit < nbits) ? (int)bit : -1;
+        }
+        if(++word >= words) return -1;
+        value = map[word];
+    }
+}
+
+// === Next-Fit: ab *hint suchen, am Ende auf 0 umbrechen, hint weiterdrehen ===
+int bitmap_find_next_fit(const uint32_t* map, uint32_t nbits, uint32_t* hint) {
+    uint32_t start = (*hint < nbits) ? *hint : 0;
+
+    int bit = bitmap_find_next_set(map, nbits, start);
+    if(bit == -1 && start > 0) {
+        bit = bitmap_find_next_set(map, start, 0);
+    }
+
+    if(bit != -1) {
+        *hint = (uint32_t)bit + 1;
+    }
+    return bit;
+}
+
+// === Gesetzte Bits zählen (popcount pro Wort) ===
+uint32_t bitmap_count_set(const uint32_t* map, uint32_t nbits) {
+    uint32_t count = 0;
+    uint32_t full = nbits / BITMAP_WORD_BITS;
+
+    for(uint32_t i = 0; i < full; i++) {
+        count += popcount32(map[i]);
+    }
+    if(nbits % BITMAP_WORD_BITS) {
+        count += popcount32(map[full] & word_mask(0, nbits % BITMAP_WORD_BITS));
+    }
+    return count;
+}
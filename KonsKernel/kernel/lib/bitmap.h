@@ -0,0 +1,39 @@
+// kernel/lib/bitmap.h
+#ifndef KERNEL_LIB_BITMAP_H
+#define KERNEL_LIB_BITMAP_H
+
+#include <stdint.h>
+
+// Bitmaps werden wortweise (32 Bit) bearbeitet. Bit n liegt in Wort n/32,
+// Bit n%32 - auf x86 (little endian) identisch mit Byte n/8, Bit n%8.
+// Bestehende uint8_t-Bitmaps können also einfach gecastet werden.
+
+#define BITMAP_WORD_BITS 32
+#define BITMAP_WORDS(bits) (((bits) + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS)
+
+// Index des niedrigsten gesetzten Bits (value != 0!)
+static inline uint32_t bit_scan_forward(uint32_t value) {
+    uint32_t index;
+    asm("bsf %1, %0" : "=r"(index) : "rm"(value));
+    return index;
+}
+
+static inline int bitmap_test(const uint32_t* map, uint32_t bit) {
+    return (map[bit / BITMAP_WORD_BITS] >> (bit % BITMAP_WORD_BITS)) & 1;
+}
+
+static inline void bitmap_set(uint32_t* map, uint32_t bit) {
+    map[bit / BITMAP_WORD_BITS] |= (1u << (bit % BITMAP_WORD_BITS));
+}
+
+static inline void bitmap_clear(uint32_t* map, uint32_t bit) {
+    map[bit / BITMAP_WORD_BITS] &= ~(1u << (bit % BITMAP_WORD_BITS));
+}
+
+void bitmap_set_range(uint32_t* map, uint32_t start, uint32_t count);
+void bitmap_clear_range(uint32_t* map, uint32_t start, uint32_t count);
+int bitmap_find_next_set(const uint32_t* map, uint32_t nbits, uint32_t start);
+int bitmap_find_next_fit(const uint32_t* map, uint32_t nbits, uint32_t* hint);
+uint32_t bitmap_count_set(const uint32_t* map, uint32_t nbits);
+
+#endif
@@ -0,0 +1,132 @@
+// kernel/lib/log.c - Kernel-Log (dmesg)
+// Lock-freier Ring für mehrere Erzeuger: ein lock xadd vergibt das Ticket,
+// danach gehört der Slot dem Erzeuger. Fertig ist ein Eintrag erst, wenn
+// seq = Ticket + 1 gesetzt ist - Leser kopieren und prüfen seq danach erneut.
+#include "log.h"
+#include "printf.h"
+#include "../drivers/screen.h"
+#include "../drivers/serial.h"
+#include "../cpu/cpu.h"
+#include <stdarg.h>
+
+extern int debug_mode;
+
+int klog_console_level = LOG_INFO;
+
+static struct log_entry log_ring[LOG_RING_SIZE];
+static volatile uint32_t log_head = 0;     // nächstes Ticket
+static uint32_t console_tail = 0;          // nächstes Ticket für die Konsole
+static uint32_t console_lost = 0;
+static uint64_t log_tsc_base = 0;
+
+// Verhindert nur, dass der Compiler Stores umsortiert - x86 hält die Reihenfolge ein
+#define log_barrier() asm volatile("" ::: "memory")
+
+void klog_init(void) {
+    if(cpu.tsc) log_tsc_base = rdtsc();
+}
+
+void klog(int level, const char* fmt, ...) {
+    uint32_t ticket = __sync_fetch_and_add(&log_head, 1);
+    struct log_entry* e = &log_ring[ticket & (LOG_RING_SIZE - 1)];
+
+    e->seq = 0;
+    log_barrier();
+
+    e->level = (uint8_t)level;
+    e->tsc = cpu.tsc ? rdtsc() : 0;
+
+    va_list args;
+    va_start(args, fmt);
+    int len = kvsnprintf(e->msg, LOG_MSG_LEN, fmt, args);
+    va_end(args);
+
+    // Einträge sind Zeilen - ein abschließendes '\n' fällt weg
+    if(len > LOG_MSG_LEN - 1) len = LOG_MSG_LEN - 1;
+    if(len > 0 && e->msg[len - 1] == '\n') e->msg[len - 1] = '\0';
+
+    log_barrier();
+    e->seq = ticket + 1;
+}
+
+// 1 = gültig kopiert, 0 = noch in Arbeit, -1 = schon überschrieben
+static int read_entry(uint32_t ticket, struct log_entry* out) {
+    struct log_entry* e = &log_ring[ticket & (LOG_RING_SIZE - 1)];
+
+    if(e->seq != ticket + 1) {
+        return (log_head - ticket > LOG_RING_SIZE) ? -1 : 0;
+    }
+
+    out->level = e->level;
+    out->tsc = e->tsc;
+    for(int i = 0; i < LOG_MSG_LEN; i++) out->msg[i] = e->msg[i];
+    out->msg[LOG_MSG_LEN - 1] = '\0';
+    log_barrier();
+
+    // Während des Kopierens überholt?
+    return e->seq == ticket + 1 ? 1 : -1;
+}
+
+static unsigned char level_color(int level) {
+    switch(level) {
+        case LOG_ERROR: return TXT_ERROR;
+        case LOG_WARN:  return TXT_WARNING;
+        case LOG_INFO:  return TXT_NORMAL;
+        default:        return TXT_GRAY;
+    }
+}
+
+static int console_wants(int level) {
+    if(level <= klog_console_level) return 1;
+    return level == LOG_DEBUG && debug_mode;
+}
+
+void klog_drain(void) {
+    struct log_entry entry;
+
+    while(console_tail != log_head) {
+        // Konsole zu langsam: die ältesten Einträge sind weg
+        if(log_head - console_tail > LOG_RING_SIZE) {
+            uint32_t oldest = log_head - LOG_RING_SIZE;
+            console_lost += oldest - console_tail;
+            console_tail = oldest;
+        }
+
+        int r = read_entry(console_tail, &entry);
+        if(r == 0) break;
+        console_tail++;
+        if(r < 0) {
+            console_lost++;
+            continue;
+        }
+
+        // Die Konsole landet ohnehin auf COM1, der Rest geht nur dorthin
+        if(console_wants(entry.level)) {
+            kprintf(level_color(entry.level), "%s\n", entry.msg);
+        } else {
+            serial_print(entry.msg);
+            serial_print("\n");
+        }
+    }
+
+    if(console_lost) {
+        kprintf(TXT_WARNING, "[klog: %u messages dropped]\n", console_lost);
+        console_lost = 0;
+    }
+}
+
+void klog_dump(void) {
+    struct log_entry entry;
+    uint32_t head = log_head;
+    uint32_t start = head > LOG_RING_SIZE ? head - LOG_RING_SIZE : 0;
+
+    for(uint32_t t = start; t != head; t++) {
+        if(read_entry(t, &entry) <= 0) continue;
+
+        uint32_t ms = 0;
+        if(cpu.tsc_khz) ms = (uint32_t)div64_32(entry.tsc - log_tsc_base, cpu.tsc_khz);
+
+        kprintf(TXT_GRAY, "[%5u.%03u] %C%s\n", ms / 1000, ms % 1000,
+                level_color(entry.level), entry.msg);
+    }
+}
@@ -0,0 +1,40 @@
+// kernel/lib/log.h
+#ifndef KERNEL_LIB_LOG_H
+#define KERNEL_LIB_LOG_H
+
+#include <stdint.h>
+
+// Schweregrade (kleiner = wichtiger)
+#define LOG_ERROR   0
+#define LOG_WARN    1
+#define LOG_INFO    2
+#define LOG_DEBUG   3
+
+// Ringgröße muss eine Zweierpotenz sein
+#define LOG_RING_SIZE   256
+#define LOG_MSG_LEN     80
+
+struct log_entry {
+    volatile uint32_t seq;  // Ticket + 1, sobald fertig geschrieben; 0 = wird geschrieben
+    uint8_t level;
+    uint64_t tsc;
+    char msg[LOG_MSG_LEN];  // eine Zeile ohne '\n'
+};
+
+// Zeitbasis für Zeitstempel, nach cpu_init aufrufen
+void klog_init(void);
+
+// Aus jedem Kontext (auch IRQ) aufrufbar: Ticket ziehen, Eintrag füllen, fertig.
+// Der Bildschirm wird dabei nicht angefasst.
+void klog(int level, const char* fmt, ...);
+
+// Neue Einträge auf die Konsole schreiben - nur außerhalb von IRQs aufrufen
+void klog_drain(void);
+
+// Alle noch im Ring liegenden Einträge mit Zeitstempel ausgeben (dmesg)
+void klog_dump(void);
+
+// Bis zu dieser Stufe landen Meldungen auf der Konsole (LOG_DEBUG nur im Debug-Modus)
+extern int klog_console_level;
+
+#endif
@@ -0,0 +1,176 @@
+// kernel/lib/mem.c
+#include "mem.h"
+#include "../cpu/cpu.h"
+#include "../cpu/fpu.h"
+
+// Wird in mem_init per CPUID/CR4 entschieden
+static int use_sse2 = 0;
+
+void mem_init(void) {
+    // SSE2 nur, wenn die CPU es kann UND fpu_init es freigeschaltet hat
+    use_sse2 = cpu.sse2 && fpu_sse_enabled();
+}
+
+int mem_sse_enabled(void) {
+    return use_sse2;
+}
+
+// === rep movsd für den Hauptteil, rep movsb für den Rest ===
+static inline void copy_rep(void* dest, const void* src, size_t n) {
+    uint32_t d0, d1, d2;
+    asm volatile(
+        "rep movsl\n"
+        "movl %4, %%ecx\n"
+        "andl $3, %%ecx\n"
+        "jz 1f\n"
+        "rep movsb\n"
+        "1:\n"
+        : "=&c"(d0), "=&D"(d1), "=&S"(d2)
+        : "0"(n / 4), "g"(n), "1"(dest), "2"(src)
+        : "memory");
+}
+
+// === SSE2: Ziel auf 16 Byte ausrichten, dann 64 Byte pro Runde ===
+// Kein xmm-Clobber nötig (und ohne -msse nicht erlaubt): der Kernel wird
+// ohne SSE übersetzt, GCC legt also nie selbst Werte in xmm-Register.
+static void copy_sse2(void* dest, const void* src, size_t n) {
+    uint8_t* d = (uint8_t*)dest;
+    const uint8_t* s = (const uint8_t*)src;
+
+    uint32_t head = (16 - ((uint32_t)d & 15)) & 15;
+    if(head) {
+        copy_rep(d, s, head);
+        d += head;
+        s += head;
+        n -= head;
+    }
+
+    uint32_t blocks = n / 64;
+    if(blocks) {
+        if(((uint32_t)s & 15) == 0) {
+            asm volatile(
+                "1:\n"
+                "movdqa 0(%1), %%xmm0\n"
+                "movdqa 16(%1), %%xmm1\n"
+                "movdqa 32(%1), %%xmm2\n"
+                "movdqa 48(%1), %%xmm3\n"
+                "movdqa %%xmm0, 0(%0)\n"
+                "movdqa %%xmm1, 16(%0)\n"
+                "movdqa %%xmm2, 32(%0)\n"
+                "movdqa %%xmm3, 48(%0)\n"
+                "addl $64, %0\n"
+                "addl $64, %1\n"
+                "decl %2\n"
+                "jnz 1b\n"
+                : "+r"(d), "+r"(s), "+r"(blocks)
+                :
+                : "memory");
+        } else {
+            asm volatile(
+                "1:\n"
+                "movdqu 0(%1), %%xmm0\n"
+                "movdqu 16(%1), %%xmm1\n"
+                "movdqu 32(%1), %%xmm2\n"
+                "movdqu 48(%1), %%xmm3\n"
+                "movdqa %%xmm0, 0(%0)\n"
+                "movdqa %%xmm1, 16(%0)\n"
+                "movdqa %%xmm2, 32(%0)\n"
+                "movdqa %%xmm3, 48(%0)\n"
+                "addl $64, %0\n"
+                "addl $64, %1\n"
+                "decl %2\n"
+                "jnz 1b\n"
+                : "+r"(d), "+r"(s), "+r"(blocks)
+                :
+                : "memory");
+        }
+        n &= 63;
+    }
+
+    if(n) copy_rep(d, s, n);
+}
+
+void* memcpy(void* dest, const void* src, size_t n) {
+    if(use_sse2 && n >= MEM_SSE_THRESHOLD && kernel_fpu_begin()) {
+        copy_sse2(dest, src, n);
+        kernel_fpu_end();
+    } else {
+        copy_rep(dest, src, n);
+    }
+    return dest;
+}
+
+// === Überlappend: vorwärts wenn möglich, sonst rückwärts mit DF=1 ===
+void* memmove(void* dest, const void* src, size_t n) {
+    uint8_t* d = (uint8_t*)dest;
+    const uint8_t* s = (const uint8_t*)src;
+
+    // Vorwärtskopie überschreibt keine noch zu lesenden Bytes
+    if(d <= s || d >= s + n) {
+        return memcpy(dest, src, n);
+    }
+
+    // Rückwärts: erst die n%4 Endbytes, dann Dwords von hinten.
+    // Während DF=1 keine Interrupts - ein Handler würde sonst rückwärts kopieren
+    uint32_t d0, d1, d2;
+    uint32_t flags = irq_save();
+    asm volatile(
+        "std\n"
+        "rep movsb\n"
+        "subl $3, %%esi\n"
+        "subl $3, %%edi\n"
+        "movl %4, %%ecx\n"
+        "rep movsl\n"
+        "cld\n"
+        : "=&c"(d0), "=&D"(d1), "=&S"(d2)
+        : "0"(n & 3), "g"(n / 4), "1"(d + n - 1), "2"(s + n - 1)
+        : "memory");
+    irq_restore(flags);
+    return dest;
+}
+
+// === rep stosd mit vervielfachtem Byte, Rest per rep stosb ===
+void* memset(void* dest, int value, size_t n) {
+    uint32_t pattern = (uint8_t)value * 0x01010101u;
+    uint32_t d0, d1;
+    asm volatile(
+        "rep stosl\n"
+        "movl %3, %%ecx\n"
+        "andl $3, %%ecx\n"
+        "jz 1f\n"
+        "rep stosb\n"
+        "1:\n"
+        : "=&c"(d0), "=&D"(d1)
+        : "0"(n / 4), "g"(n), "a"(pattern), "1"(dest)
+        : "memory");
+    return dest;
+}
+
+void* memsetw(void* dest, uint16_t value, size_t count) {
+    uint32_t d0, d1;
+    asm volatile(
+        "rep stosw\n"
+        : "=&c"(d0), "=&D"(d1)
+        : "0"(count), "a"(value), "1"(dest)
+        : "memory");
+    return dest;
+}
+
+// === Dword-weise vergleichen, im ersten ungleichen Wort byteweise ===
+int memcmp(const void* a, const void* b, size_t n) {
+    const uint8_t* p = (const uint8_t*)a;
+    const uint8_t* q = (const uint8_t*)b;
+
+    while(n >= 4 && *(const uint32_t*)p == *(const uint32_t*)q) {
+        p += 4;
+        q += 4;
+        n -= 4;
+    }
+    while(n > 0) {
+        if(*p != *q) return *p - *q;
+        p++;
+        q++;
+        n--;
+    }
+    return 0;
+}
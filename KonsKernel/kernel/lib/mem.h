@@ -0,0 +1,22 @@
+// kernel/lib/mem.h
+#ifndef KERNEL_LIB_MEM_H
+#define KERNEL_LIB_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Ab dieser Größe lohnt sich der SSE2-Pfad (falls aktiv)
+#define MEM_SSE_THRESHOLD 512
+
+void mem_init(void);
+int mem_sse_enabled(void);
+
+void* memcpy(void* dest, const void* src, size_t n);
+void* memmove(void* dest, const void* src, size_t n);
+void* memset(void* dest, int value, size_t n);
+int memcmp(const void* a, const void* b, size_t n);
+
+// 16-Bit Muster füllen (z.B. VGA-Zellen: Farbe << 8 | Zeichen)
+void* memsetw(void* dest, uint16_t value, size_t count);
+
+#endif
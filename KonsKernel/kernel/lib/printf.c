@@ -0,0 +1,181 @@
+// kernel/lib/printf.c - kprintf / ksnprintf
+#include "printf.h"
+#include "../drivers/screen.h"
+
+// Im kprintf-Puffer: Markierung, danach das neue Farbbyte
+#define PRINTF_COLOR_ESC 0x01
+
+typedef struct {
+    char* buf;
+    uint32_t size;
+    uint32_t len;       // Länge ohne Kürzung
+    int colors;         // %C als Markierung ablegen (nur kprintf)
+} printf_out_t;
+
+static void out_char(printf_out_t* out, char c) {
+    if(out->len + 1 < out->size) out->buf[out->len] = c;
+    out->len++;
+}
+
+static void out_pad(printf_out_t* out, char c, int count) {
+    while(count-- > 0) out_char(out, c);
+}
+
+// Zahl rückwärts in tmp, dann mit Breite/Füllung ausgeben
+static void out_number(printf_out_t* out, uint32_t value, int base, int upper,
+                       int negative, int width, int zero, int left) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[12];
+    int n = 0;
+
+    do {
+        tmp[n++] = digits[value % base];
+        value /= base;
+    } while(value);
+
+    int len = n + (negative ? 1 : 0);
+    if(!left && !zero) out_pad(out, ' ', width - len);
+    if(negative) out_char(out, '-');
+    if(!left && zero) out_pad(out, '0', width - len);
+    while(n > 0) out_char(out, tmp[--n]);
+    if(left) out_pad(out, ' ', width - len);
+}
+
+static void out_string(printf_out_t* out, const char* s, int width, int left) {
+    if(!s) s = "(null)";
+    int len = 0;
+    while(s[len]) len++;
+
+    if(!left) out_pad(out, ' ', width - len);
+    while(*s) out_char(out, *s++);
+    if(left) out_pad(out, ' ', width - len);
+}
+
+static int format(printf_out_t* out, const char* fmt, va_list args) {
+    for(; *fmt; fmt++) {
+        if(*fmt != '%') {
+            out_char(out, *fmt);
+            continue;
+        }
+        fmt++;
+
+        int left = 0;
+        int zero = 0;
+        int width = 0;
+
+        // Flags
+        while(*fmt == '-' || *fmt == '0') {
+            if(*fmt == '-') left = 1;
+            else zero = 1;
+            fmt++;
+        }
+
+        // Breite
+        if(*fmt == '*') {
+            width = va_arg(args, int);
+            if(width < 0) {
+                left = 1;
+                width = -width;
+            }
+            fmt++;
+        } else {
+            while(*fmt >= '0' && *fmt <= '9') {
+                width = width * 10 + (*fmt - '0');
+                fmt++;
+            }
+        }
+        if(left) zero = 0;
+
+        // 'l' ist auf i386 gleich int
+        while(*fmt == 'l') fmt++;
+
+        switch(*fmt) {
+            case 'd':
+            case 'i': {
+                int value = va_arg(args, int);
+                uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+                out_number(out, magnitude, 10, 0, value < 0, width, zero, left);
+                break;
+            }
+            case 'u':
+                out_number(out, va_arg(args, uint32_t), 10, 0, 0, width, zero, left);
+                break;
+            case 'x':
+            case 'X':
+                out_number(out, va_arg(args, uint32_t), 16, *fmt == 'X', 0, width, zero, left);
+                break;
+            case 'p':
+                out_char(out, '0');
+                out_char(out, 'x');
+                out_number(out, (uint32_t)va_arg(args, void*), 16, 1, 0, 8, 1, 0);
+                break;
+            case 's':
+                out_string(out, va_arg(args, const char*), width, left);
+                break;
+            case 'c':
+                if(!left) out_pad(out, ' ', width - 1);
+                out_char(out, (char)va_arg(args, int));
+                if(left) out_pad(out, ' ', width - 1);
+                break;
+            case 'C': {
+                unsigned char color = (unsigned char)va_arg(args, int);
+                // Markierung nur, wenn beide Bytes noch passen
+                if(out->colors && out->len + 2 < out->size) {
+                    out_char(out, PRINTF_COLOR_ESC);
+                    out_char(out, (char)color);
+                }
+                break;
+            }
+            case '%':
+                out_char(out, '%');
+                break;
+            case '\0':
+                fmt--;      // '%' am Ende
+                break;
+            default:
+                out_char(out, '%');
+                out_char(out, *fmt);
+                break;
+        }
+    }
+
+    if(out->size > 0) {
+        out->buf[out->len < out->size ? out->len : out->size - 1] = '\0';
+    }
+    return out->len;
+}
+
+int kvsnprintf(char* buf, uint32_t size, const char* fmt, va_list args) {
+    printf_out_t out = { buf, size, 0, 0 };
+    return format(&out, fmt, args);
+}
+
+int ksnprintf(char* buf, uint32_t size, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int len = kvsnprintf(buf, size, fmt, args);
+    va_end(args);
+    return len;
+}
+
+void kprintf(unsigned char color, const char* fmt, ...) {
+    char buf[KPRINTF_BUFFER];
+    printf_out_t out = { buf, sizeof(buf), 0, 1 };
+
+    va_list args;
+    va_start(args, fmt);
+    int len = format(&out, fmt, args);
+    va_end(args);
+    if(len >= (int)sizeof(buf)) len = sizeof(buf) - 1;
+
+    // Ein kwrite pro Farbabschnitt
+    int start = 0;
+    for(int i = 0; i < len; i++) {
+        if(buf[i] != PRINTF_COLOR_ESC || i + 1 >= len) continue;
+        kwrite(buf + start, i - start, color);
+        color = (unsigned char)buf[i + 1];
+        i++;
+        start = i + 1;
+    }
+    kwrite(buf + start, len - start, color);
+}
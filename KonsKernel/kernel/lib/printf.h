@@ -0,0 +1,23 @@
+// kernel/lib/printf.h
+#ifndef KERNEL_LIB_PRINTF_H
+#define KERNEL_LIB_PRINTF_H
+
+#include <stdarg.h>
+#include <stdint.h>
+
+// Maximale Länge einer kprintf-Ausgabe (Stack-Puffer pro Aufruf)
+#define KPRINTF_BUFFER 256
+
+// Unterstützt: %d %i %u %x %X %p %s %c %%
+// Flags: '-' (links), '0' (Nullen), Breite als Zahl oder '*'
+// kprintf zusätzlich: %C wechselt die Farbe (Argument: Farbbyte)
+//   kprintf(TXT_NORMAL, "Free: %C%u%C KB\n", TXT_SUCCESS, free_kb, TXT_NORMAL);
+
+// Rückgabe wie C: Länge ohne Kürzung (ohne '\0')
+int kvsnprintf(char* buf, uint32_t size, const char* fmt, va_list args);
+int ksnprintf(char* buf, uint32_t size, const char* fmt, ...);
+
+// Formatiert in einen Stack-Puffer, dann ein Schreibvorgang pro Farbabschnitt
+void kprintf(unsigned char color, const char* fmt, ...);
+
+#endif
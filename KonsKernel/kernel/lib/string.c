@@ -1,22 +1,248 @@
 // kernel/lib/string.c
 #include "string.h"
+#include "bitmap.h"
+#include "mem.h"
+#include "../cpu/cpu.h"
+#include "../cpu/fpu.h"
 
 // WICHTIG: Keine system headers! Nur unsere eigenen!
 
+// === Wortweise: "enthält das Wort ein Null-Byte?" ===
+// (w - 0x01..) setzt das High-Bit jedes Bytes, das 0 war (oder durch Borgen
+// von einem Null-Byte darunter), ~w filtert Bytes >= 0x80 wieder heraus.
+#define ONES  0x01010101u
+#define HIGHS 0x80808080u
+#define HAS_ZERO(w) (((w) - ONES) & ~(w) & HIGHS)
+
+// Ungeausrichtete Lesezugriffe dürfen nie über eine Seitengrenze laufen:
+// hinter dem Terminator kann die nächste Seite ungemappt sein
+#define PAGE_OFFSET(p) ((uint32_t)(p) & 0xFFF)
+#define CROSSES_PAGE(p, n) (PAGE_OFFSET(p) > 4096 - (n))
+
+enum { STR_WORD, STR_SSE2, STR_SSE42 };
+static int str_level = STR_WORD;
+
+// Ab STR_SIMD_MIN Bytes: gewählte Variante
+static int (*strlen_tail)(const char* s) = strlen_word;
+static int (*strcmp_tail)(const char* s1, const char* s2) = strcmp_word;
+
+void string_init(void) {
+    if(cpu.sse42 && fpu_sse_enabled()) {
+        str_level = STR_SSE42;
+        strlen_tail = strlen_sse42;
+        strcmp_tail = strcmp_sse42;
+    } else if(cpu.sse2 && fpu_sse_enabled()) {
+        str_level = STR_SSE2;
+        strlen_tail = strlen_sse2;
+    }
+}
+
+const char* string_impl_name(void) {
+    if(str_level == STR_SSE42) return "sse4.2";
+    if(str_level == STR_SSE2) return "sse2";
+    return "word";
+}
+
+// ========================
+// STRLEN
+// ========================
+int strlen_word(const char* s) {
+    const char* p = s;
+
+    // Ausgerichtete Wörter laufen nie über eine Seitengrenze
+    while((uint32_t)p & 3) {
+        if(!*p) return p - s;
+        p++;
+    }
+
+    const uint32_t* w = (const uint32_t*)p;
+    while(!HAS_ZERO(*w)) w++;
+
+    p = (const char*)w;
+    while(*p) p++;
+    return p - s;
+}
+
+// p muss 16-Byte aligned sein, Aufrufer hält kernel_fpu
+static const char* scan_zero_sse2(const char* p) {
+    uint32_t mask;
+    asm volatile(
+        "pxor %%xmm0, %%xmm0\n"
+        "1:\n"
+        "movdqa (%0), %%xmm1\n"
+        "pcmpeqb %%xmm0, %%xmm1\n"
+        "pmovmskb %%xmm1, %1\n"
+        "testl %1, %1\n"
+        "jnz 2f\n"
+        "addl $16, %0\n"
+        "jmp 1b\n"
+        "2:\n"
+        : "+r"(p), "=&r"(mask)
+        :
+        : "memory", "cc");
+    return p + bit_scan_forward(mask);
+}
+
+// pcmpistri EQUAL_EACH gegen einen leeren String: ECX = Index des Terminators,
+// ZF = Block enthält ein Null-Byte
+static const char* scan_zero_sse42(const char* p) {
+    uint32_t index;
+    asm volatile(
+        "pxor %%xmm0, %%xmm0\n"
+        "1:\n"
+        "pcmpistri $0x08, (%0), %%xmm0\n"
+        "jz 2f\n"
+        "addl $16, %0\n"
+        "jmp 1b\n"
+        "2:\n"
+        : "+r"(p), "=c"(index)
+        :
+        : "memory", "cc");
+    return p + index;
+}
+
+int strlen_sse2(const char* s) {
+    const char* p = s;
+    while((uint32_t)p & 15) {
+        if(!*p) return p - s;
+        p++;
+    }
+    if(!kernel_fpu_begin()) return (p - s) + strlen_word(p);
+    p = scan_zero_sse2(p);
+    kernel_fpu_end();
+    return p - s;
+}
+
+int strlen_sse42(const char* s) {
+    const char* p = s;
+    while((uint32_t)p & 15) {
+        if(!*p) return p - s;
+        p++;
+    }
+    if(!kernel_fpu_begin()) return (p - s) + strlen_word(p);
+    p = scan_zero_sse42(p);
+    kernel_fpu_end();
+    return p - s;
+}
+
 int strlen(const char* s) {
-    int len = 0;
-    while(s[len]) len++;
-    return len;
+    const char* p = s;
+    while((uint32_t)p & 3) {
+        if(!*p) return p - s;
+        p++;
+    }
+
+    // Vorlauf wortweise
+    const uint32_t* w = (const uint32_t*)p;
+    const uint32_t* end = w + STR_SIMD_MIN / 4;
+    while(w < end) {
+        if(HAS_ZERO(*w)) {
+            p = (const char*)w;
+            while(*p) p++;
+            return p - s;
+        }
+        w++;
+    }
+
+    p = (const char*)w;
+    return (p - s) + strlen_tail(p);
 }
 
-int strcmp(const char* s1, const char* s2) {
-    while(*s1 && (*s1 == *s2)) {
-        s1++;
-        s2++;
+// ========================
+// STRCMP
+// ========================
+
+// Vergleicht bis zu limit Bytes wortweise. Rückgabe 1 = entschieden (*result),
+// 0 = limit erreicht, *p1/*p2 zeigen hinter den verglichenen Teil.
+static int cmp_words(const char** p1, const char** p2, uint32_t limit, int* result) {
+    const unsigned char* s1 = (const unsigned char*)*p1;
+    const unsigned char* s2 = (const unsigned char*)*p2;
+    uint32_t done = 0;
+
+    while(done < limit) {
+        while(done < limit && !CROSSES_PAGE(s1, 4) && !CROSSES_PAGE(s2, 4)) {
+            uint32_t a = *(const uint32_t*)s1;
+            uint32_t b = *(const uint32_t*)s2;
+            if(a != b || HAS_ZERO(a)) break;
+            s1 += 4;
+            s2 += 4;
+            done += 4;
+        }
+
+        // Unterschied/Terminator steckt in den nächsten 4 Bytes - oder
+        // wir sind an einer Seitengrenze und gehen byteweise darüber
+        for(int i = 0; i < 4; i++) {
+            if(!*s1 || *s1 != *s2) {
+                *result = *s1 - *s2;
+                return 1;
+            }
+            s1++;
+            s2++;
+        }
+        done += 4;
+    }
+
+    *p1 = (const char*)s1;
+    *p2 = (const char*)s2;
+    return 0;
+}
+
+int strcmp_word(const char* s1, const char* s2) {
+    int result = 0;
+    cmp_words(&s1, &s2, 0xFFFFFFFF, &result);
+    return result;
+}
+
+// pcmpistri EQUAL_EACH|NEGATIVE_POLARITY: CF = Unterschied (oder nur ein
+// String endet) bei Index ECX, ZF = s2-Block enthält den Terminator
+int strcmp_sse42(const char* s1, const char* s2) {
+    if(!kernel_fpu_begin()) return strcmp_word(s1, s2);
+
+    while(1) {
+        if(CROSSES_PAGE(s1, 16) || CROSSES_PAGE(s2, 16)) {
+            for(int i = 0; i < 16; i++) {
+                if(!*s1 || *s1 != *s2) goto done;
+                s1++;
+                s2++;
+            }
+            continue;
+        }
+
+        uint32_t index;
+        uint8_t differ, ended;
+        asm volatile(
+            "movdqu (%3), %%xmm1\n"
+            "pcmpistri $0x18, (%4), %%xmm1\n"
+            "setc %1\n"
+            "setz %2\n"
+            : "=c"(index), "=q"(differ), "=q"(ended)
+            : "r"(s1), "r"(s2)
+            : "memory", "cc");
+
+        if(differ) {
+            s1 += index;
+            s2 += index;
+            break;
+        }
+        if(ended) {
+            kernel_fpu_end();
+            return 0;
+        }
+        s1 += 16;
+        s2 += 16;
     }
+
+done:
+    kernel_fpu_end();
     return *(const unsigned char*)s1 - *(const unsigned char*)s2;
 }
 
+int strcmp(const char* s1, const char* s2) {
+    int result;
+    if(cmp_words(&s1, &s2, STR_SIMD_MIN, &result)) return result;
+    return strcmp_tail(s1, s2);
+}
+
 void strcpy(char* dest, const char* src) {
     while(*src) {
         *dest++ = *src++;
@@ -24,23 +250,118 @@ void strcpy(char* dest, const char* src) {
     *dest = '\0';
 }
 
+// === Präfix wortweise vergleichen ===
 int strstart(const char* str, const char* prefix) {
-    while(*prefix) {
-        if(*prefix++ != *str++) return 0;
+    while(1) {
+        while(!CROSSES_PAGE(str, 4) && !CROSSES_PAGE(prefix, 4)) {
+            uint32_t p = *(const uint32_t*)prefix;
+            if(HAS_ZERO(p) || p != *(const uint32_t*)str) break;
+            str += 4;
+            prefix += 4;
+        }
+
+        for(int i = 0; i < 4; i++) {
+            if(!*prefix) return 1;
+            if(*prefix++ != *str++) return 0;
+        }
     }
-    return 1;
+}
+
+// ========================
+// XSTRSTR - Two-Way (Crochemore/Perrin)
+// ========================
+// Linear in Heuhaufen + Nadel, ohne Tabellen: die Nadel wird an ihrem
+// kritischen Punkt ms geteilt, rechts wird vorwärts, links rückwärts
+// verglichen. Bei periodischer Nadel merkt sich mem, was schon passt.
+
+// Maximales Suffix bzgl. < (invert = 0) bzw. > (invert = 1)
+static int max_suffix(const unsigned char* n, int l, int invert, int* period) {
+    int ip = -1;
+    int jp = 0;
+    int k = 1;
+    int p = 1;
+
+    while(jp + k < l) {
+        unsigned char a = n[ip + k];
+        unsigned char b = n[jp + k];
+        if(a == b) {
+            if(k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if(invert ? (a < b) : (a > b)) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+
+    *period = p;
+    return ip;
+}
+
+static char* two_way(const unsigned char* h, int hl, const unsigned char* n, int l) {
+    const unsigned char* end = h + hl;
+    int p, p2;
+
+    // Kritischer Punkt: das längere der beiden maximalen Suffixe
+    int ms = max_suffix(n, l, 0, &p);
+    int ms2 = max_suffix(n, l, 1, &p2);
+    if(ms2 > ms) {
+        ms = ms2;
+        p = p2;
+    }
+
+    int mem0;
+    if(memcmp(n, n + p, ms + 1) != 0) {
+        // Nicht periodisch: Verschiebung um mehr als die halbe Nadel
+        mem0 = 0;
+        p = (ms > l - ms - 1 ? ms : l - ms - 1) + 1;
+    } else {
+        mem0 = l - p;
+    }
+
+    int mem = 0;
+    while(end - h >= l) {
+        // Rechte Hälfte
+        int k = (ms + 1 > mem) ? ms + 1 : mem;
+        while(k < l && n[k] == h[k]) k++;
+        if(k < l) {
+            h += k - ms;
+            mem = 0;
+            continue;
+        }
+
+        // Linke Hälfte
+        k = ms + 1;
+        while(k > mem && n[k - 1] == h[k - 1]) k--;
+        if(k <= mem) return (char*)h;
+
+        h += p;
+        mem = mem0;
+    }
+    return NULL;
 }
 
 char* xstrstr(const char* haystack, const char* needle) {
     if(!*needle) return (char*)haystack;
-    for(; *haystack; haystack++) {
-        const char* h = haystack;
-        const char* n = needle;
-        while(*h && *n && *h == *n) {
-            h++;
-            n++;
+
+    // Ein Zeichen: einfache Suche
+    if(!needle[1]) {
+        for(; *haystack; haystack++) {
+            if(*haystack == *needle) return (char*)haystack;
         }
-        if(!*n) return (char*)haystack;
+        return NULL;
     }
-    return NULL;
+
+    int l = strlen(needle);
+    int hl = strlen(haystack);
+    if(hl < l) return NULL;
+
+    return two_way((const unsigned char*)haystack, hl, (const unsigned char*)needle, l);
 }
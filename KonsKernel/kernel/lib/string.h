@@ -7,10 +7,24 @@
 #define NULL ((void*)0)
 #endif
 
+// Bis hier wird wortweise gesucht - kurze Strings (Befehle, Dateinamen)
+// zahlen nie für kernel_fpu_begin
+#define STR_SIMD_MIN 64
+
+void string_init(void);
+const char* string_impl_name(void);
+
 int strlen(const char* s);
 int strcmp(const char* s1, const char* s2);
 void strcpy(char* dest, const char* src);
 int strstart(const char* str, const char* prefix);
 char* xstrstr(const char* haystack, const char* needle);
 
+// Einzelne Varianten (für bench str)
+int strlen_word(const char* s);
+int strlen_sse2(const char* s);
+int strlen_sse42(const char* s);
+int strcmp_word(const char* s1, const char* s2);
+int strcmp_sse42(const char* s1, const char* s2);
+
 #endif
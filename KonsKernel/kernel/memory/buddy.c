@@ -0,0 +1,189 @@
+// kernel/memory/buddy.c
+#include <stddef.h>
+#include <stdint.h>
+#include "buddy.h"
+#include "heap.h"
+#include "../drivers/screen.h"
+#include "../lib/printf.h"
+#include "../lib/utils.h"
+#include "../lib/bitmap.h"
+
+// Freier Block: Listen-Zeiger liegen in der (identity-mapped) Seite selbst
+typedef struct buddy_block {
+    struct buddy_block* next;
+    struct buddy_block* prev;
+} buddy_block_t;
+
+static buddy_block_t* free_area[BUDDY_ORDERS];
+static uint32_t free_count[BUDDY_ORDERS];
+static uint32_t free_area_map = 0;     // Bit n gesetzt = free_area[n] nicht leer
+
+static uint8_t* frame_info = NULL;     // Ein Byte pro Frame (FRAME_*)
+static uint32_t frame_limit = 0;       // Anzahl verwalteter Frames (max PFN)
+static uint32_t frames_free = 0;
+
+#define PFN(addr)       ((uint32_t)(addr) / PAGE_SIZE)
+#define PFN_ADDR(pfn)   ((void*)((pfn) * PAGE_SIZE))
+
+// === Page-Bitmap spiegeln (nur die ersten 256 MB sind abgebildet) ===
+static void bitmap_mark(uint32_t pfn, uint32_t count, int free) {
+    if(pfn >= BITMAP_SIZE * 8) return;
+    if(pfn + count > BITMAP_SIZE * 8) count = BITMAP_SIZE * 8 - pfn;
+
+    if(free) bitmap_set_range((uint32_t*)page_bitmap, pfn, count);
+    else bitmap_clear_range((uint32_t*)page_bitmap, pfn, count);
+}
+
+static void area_push(uint32_t pfn, uint32_t order) {
+    buddy_block_t* block = (buddy_block_t*)PFN_ADDR(pfn);
+
+    block->prev = NULL;
+    block->next = free_area[order];
+    if(block->next) block->next->prev = block;
+    free_area[order] = block;
+    free_count[order]++;
+    free_area_map |= (1u << order);
+
+    frame_info[pfn] = FRAME_FREE | order;
+}
+
+static void area_remove(uint32_t pfn, uint32_t order) {
+    buddy_block_t* block = (buddy_block_t*)PFN_ADDR(pfn);
+
+    if(block->prev) block->prev->next = block->next;
+    else free_area[order] = block->next;
+    if(block->next) block->next->prev = block->prev;
+    free_count[order]--;
+    if(!free_area[order]) free_area_map &= ~(1u << order);
+
+    frame_info[pfn] = FRAME_TAIL;
+}
+
+// === Block freigeben und mit Buddies verschmelzen: O(log n) ===
+static void buddy_release(uint32_t pfn, uint32_t order) {
+    while(order < BUDDY_MAX_ORDER) {
+        uint32_t buddy = pfn ^ (1u << order);
+        if(buddy >= frame_limit) break;
+        if(frame_info[buddy] != (FRAME_FREE | order)) break;
+
+        area_remove(buddy, order);
+        frame_info[pfn] = FRAME_TAIL;
+        pfn &= ~(1u << order);
+        order++;
+    }
+    area_push(pfn, order);
+}
+
+// === Initialisierung ===
+// Legt frame_info ab meta_start an und gibt das Ende der Metadaten zurück.
+// Alle Frames sind danach reserviert, bis buddy_add_range sie freigibt.
+uint32_t buddy_init(uint32_t meta_start, uint32_t max_pfn) {
+    frame_info = (uint8_t*)meta_start;
+    frame_limit = max_pfn;
+
+    for(uint32_t i = 0; i < frame_limit; i++) {
+        frame_info[i] = FRAME_INVALID;
+    }
+    for(int i = 0; i < BUDDY_ORDERS; i++) {
+        free_area[i] = NULL;
+        free_count[i] = 0;
+    }
+    free_area_map = 0;
+    frames_free = 0;
+
+    return (meta_start + frame_limit + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+}
+
+// === Freien physischen Bereich [start, end) übergeben ===
+void buddy_add_range(uint32_t start, uint32_t end) {
+    uint32_t pfn = (start + PAGE_SIZE - 1) / PAGE_SIZE;
+    uint32_t last = end / PAGE_SIZE;
+    if(last > frame_limit) last = frame_limit;
+
+    while(pfn < last) {
+        // Größten alignierten Block nehmen, der noch in den Bereich passt
+        uint32_t order = BUDDY_MAX_ORDER;
+        while(order > 0 && ((pfn & ((1u << order) - 1)) || pfn + (1u << order) > last)) {
+            order--;
+        }
+
+        bitmap_mark(pfn, 1u << order, 1);
+        frames_free += 1u << order;
+        buddy_release(pfn, order);
+        pfn += 1u << order;
+    }
+}
+
+// === 2^order zusammenhängende Seiten holen ===
+void* alloc_pages(uint32_t order) {
+    if(order > BUDDY_MAX_ORDER) return NULL;
+
+    // Kleinste nicht-leere Ordnung >= order per bsf
+    uint32_t avail = free_area_map & ~((1u << order) - 1);
+    if(!avail) {
+        kprint("PAGE ALLOC: Out of pages!\n", 0x4F);
+        return NULL;
+    }
+
+    uint32_t current;
+    asm("bsf %1, %0" : "=r"(current) : "rm"(avail));
+
+    uint32_t pfn = PFN(free_area[current]);
+    area_remove(pfn, current);
+
+    // Überschüssige Hälften zurück in die kleineren Listen
+    while(current > order) {
+        current--;
+        area_push(pfn + (1u << current), current);
+    }
+
+    frame_info[pfn] = FRAME_USED | order;
+
+    uint32_t count = 1u << order;
+    bitmap_mark(pfn, count, 0);
+    frames_free -= count;
+    used_pages += count;
+    free_page_count -= count;
+    used_memory += count * PAGE_SIZE;
+    free_memory -= count * PAGE_SIZE;
+
+    return PFN_ADDR(pfn);
+}
+
+// === Seiten zurückgeben (order muss zur Allokation passen) ===
+void free_pages(void* addr, uint32_t order) {
+    uint32_t pfn = PFN(addr);
+
+    if(((uint32_t)addr & (PAGE_SIZE - 1)) || pfn >= frame_limit ||
+       frame_info[pfn] != (FRAME_USED | order)) {
+        kprintf(0x1E, "WARNING: Bad free_pages %X\n", (uint32_t)addr);
+        return;
+    }
+
+    uint32_t count = 1u << order;
+    bitmap_mark(pfn, count, 1);
+    frames_free += count;
+    used_pages -= count;
+    free_page_count += count;
+    used_memory -= count * PAGE_SIZE;
+    free_memory += count * PAGE_SIZE;
+
+    buddy_release(pfn, order);
+}
+
+uint32_t buddy_free_frames(void) {
+    return frames_free;
+}
+
+// === buddyinfo: freie Blöcke pro Ordnung ===
+void buddy_info(void) {
+    kprint("\nOrder  Size     Free blocks\n", TXT_INFO);
+    for(int order = 0; order < BUDDY_ORDERS; order++) {
+        kprintf(TXT_NORMAL, "  %C%-5d%C%5u KB  %C%u\n", TXT_CYAN, order, TXT_NORMAL,
+                (PAGE_SIZE / 1024) << order, free_count[order] ? TXT_SUCCESS : TXT_GRAY,
+                free_count[order]);
+    }
+
+    kprintf(TXT_NORMAL, "Free frames: %C%u%C (%C%u%C KB)\n", TXT_SUCCESS, frames_free, TXT_NORMAL,
+            TXT_SUCCESS, frames_free * (PAGE_SIZE / 1024), TXT_NORMAL);
+}
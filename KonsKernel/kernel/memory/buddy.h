@@ -0,0 +1,26 @@
+// kernel/memory/buddy.h
+#ifndef KERNEL_MEMORY_BUDDY_H
+#define KERNEL_MEMORY_BUDDY_H
+
+#include <stdint.h>
+
+// === Buddy Konstanten ===
+#define BUDDY_MAX_ORDER     10          // 2^10 Seiten = 4 MB Blöcke
+#define BUDDY_ORDERS        (BUDDY_MAX_ORDER + 1)
+
+// Zustand pro Frame (frame_info[pfn]), nur am Blockanfang gültig
+#define FRAME_INVALID       0xFF        // Nicht verwaltet / reserviert
+#define FRAME_FREE          0x80        // Kopf eines freien Blocks (| order)
+#define FRAME_USED          0x40        // Kopf eines belegten Blocks (| order)
+#define FRAME_TAIL          0x20        // Innerhalb eines Blocks
+#define FRAME_ORDER_MASK    0x0F
+
+// === Funktionen ===
+uint32_t buddy_init(uint32_t meta_start, uint32_t max_pfn);
+void buddy_add_range(uint32_t start, uint32_t end);
+void* alloc_pages(uint32_t order);
+void free_pages(void* addr, uint32_t order);
+uint32_t buddy_free_frames(void);
+void buddy_info(void);
+
+#endif
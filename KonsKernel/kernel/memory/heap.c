@@ -1,155 +1,266 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "heap.h"
+#include "buddy.h"
+#include "../kernel.h"
 #include "../drivers/screen.h"
 #include "../lib/utils.h"
+#include "../lib/bitmap.h"
+#include "../lib/mem.h"
+#include "../lib/printf.h"
+#include "../lib/log.h"
 
 // === Heap Variablen ===
 uint32_t heap_pointer = HEAP_START;
 uint32_t heap_end = HEAP_END;  // NICHT static! (weil extern in .h)
-alloc_info_t allocations[MAX_ALLOCS];
 int alloc_count = 0;
 
+// === Free-Lists (segregiert nach Zweierpotenzen) ===
+static heap_free_block_t* heap_bins[HEAP_BINS];
+static uint32_t heap_bin_map = 0;      // Bit n gesetzt = heap_bins[n] nicht leer
+static uint32_t heap_last_size = 0;    // Größe des Blocks direkt unter heap_pointer
+static uint32_t heap_free_blocks = 0;
+static uint32_t heap_free_bytes = 0;
+
 // === Memory Variablen ===
 uint32_t total_memory = 0;
 uint32_t free_memory = 0;
 uint32_t used_memory = 0;
 uint32_t kernel_memory = 0;
-uint8_t page_bitmap[BITMAP_SIZE];
+uint8_t page_bitmap[BITMAP_SIZE] __attribute__((aligned(4)));  // wortweise benutzt (lib/bitmap)
 uint32_t total_pages = 0;
-uint32_t free_pages = 0;
+uint32_t free_page_count = 0;
 uint32_t used_pages = 0;
 
-// === Multiboot Struktur (hier definiert, da nicht in eigenem Header) ===
-struct multiboot_info {
-    uint32_t flags;
-    uint32_t mem_lower;
-    uint32_t mem_upper;
-    uint32_t boot_device;
-    uint32_t cmdline;
-    uint32_t mods_count;
-    uint32_t mods_addr;
-    // ... weitere Felder (nur die brauchen wir)
-};
-
-// === Hilfsfunktionen (static) ===
-static void hex_to_str(uint32_t num, char* str) {
-    const char* digits = "0123456789ABCDEF";
-    for(int i = 0; i < 8; i++) {
-        str[i] = digits[(num >> (28 - i*4)) & 0xF];
-    }
-    str[8] = '\0';
+// === Physische Speicherkarte ===
+mem_region_t mem_regions[MAX_MEM_REGIONS];
+int mem_region_count = 0;
+static mem_region_t reserved_regions[MAX_RESERVED];
+static int reserved_count = 0;
+
+// === Ende des Kernel-Images (aus linker.ld) ===
+extern uint8_t kernel_end;
+
+// === Block-Hilfsfunktionen ===
+#define HEAP_HDR_SIZE   ((uint32_t)sizeof(heap_block_t))
+
+static inline heap_block_t* block_from_ptr(void* ptr) {
+    return (heap_block_t*)((uint8_t*)ptr - HEAP_HDR_SIZE);
 }
 
-static void int_to_str(int num, char* str) {
-    if(num == 0) {
-        str[0] = '0';
-        str[1] = '\0';
-        return;
-    }
+static inline void* block_to_ptr(heap_block_t* block) {
+    return (uint8_t*)block + HEAP_HDR_SIZE;
+}
 
-    char temp[16];
-    int i = 0;
-    int is_negative = 0;
+static inline heap_block_t* block_next(heap_block_t* block) {
+    return (heap_block_t*)((uint8_t*)block + block->size);
+}
 
-    if(num < 0) {
-        is_negative = 1;
-        num = -num;
-    }
+static inline heap_block_t* block_prev(heap_block_t* block) {
+    return (heap_block_t*)((uint8_t*)block - block->prev_size);
+}
 
-    while(num > 0) {
-        temp[i++] = '0' + (num % 10);
-        num /= 10;
-    }
+// Bin = Index des höchsten gesetzten Bits (bsr), also O(1)
+static inline int size_to_bin(uint32_t size) {
+    uint32_t bin;
+    asm("bsr %1, %0" : "=r"(bin) : "rm"(size));
+    return bin;
+}
 
-    int j = 0;
-    if(is_negative) {
-        str[j++] = '-';
-    }
+static inline int lowest_bin(uint32_t mask) {
+    uint32_t bin;
+    asm("bsf %1, %0" : "=r"(bin) : "rm"(mask));
+    return bin;
+}
 
-    for(i = i - 1; i >= 0; i--) {
-        str[j++] = temp[i];
+static void bin_insert(heap_block_t* block) {
+    heap_free_block_t* fb = (heap_free_block_t*)block;
+    int bin = size_to_bin(block->size);
+
+    block->magic = HEAP_FREE_MAGIC;
+    fb->prev = NULL;
+    fb->next = heap_bins[bin];
+    if(fb->next) fb->next->prev = fb;
+    heap_bins[bin] = fb;
+    heap_bin_map |= (1u << bin);
+
+    heap_free_blocks++;
+    heap_free_bytes += block->size;
+}
+
+static void bin_remove(heap_block_t* block) {
+    heap_free_block_t* fb = (heap_free_block_t*)block;
+    int bin = size_to_bin(block->size);
+
+    if(fb->prev) fb->prev->next = fb->next;
+    else heap_bins[bin] = fb->next;
+    if(fb->next) fb->next->prev = fb->prev;
+    if(!heap_bins[bin]) heap_bin_map &= ~(1u << bin);
+
+    heap_free_blocks--;
+    heap_free_bytes -= block->size;
+}
+
+// Passenden freien Block suchen: erst die eigene Bin (begrenzt),
+// dann die nächste nicht-leere größere Bin per bsf - dort passt jeder Block.
+static heap_block_t* find_free_block_fit(uint32_t size) {
+    int bin = size_to_bin(size);
+
+    heap_free_block_t* fb = heap_bins[bin];
+    for(int probes = 0; fb && probes < HEAP_BIN_PROBES; probes++, fb = fb->next) {
+        if(fb->header.size >= size) return &fb->header;
     }
-    str[j] = '\0';
+
+    if(bin + 1 >= HEAP_BINS) return NULL;
+    uint32_t larger = heap_bin_map & ~((2u << bin) - 1);
+    if(!larger) return NULL;
+
+    return &heap_bins[lowest_bin(larger)]->header;
 }
 
-// === Freien Slot finden ===
-static int find_free_slot(void) {
-    for(int i = 0; i < MAX_ALLOCS; i++) {
-        if(!allocations[i].used) {
-            return i;
-        }
+// Block auf 'size' verkleinern, Rest als freien Block einhängen
+static void split_block(heap_block_t* block, uint32_t size) {
+    uint32_t rest = block->size - size;
+    if(rest < HEAP_MIN_BLOCK) return;
+
+    block->size = size;
+
+    heap_block_t* tail = block_next(block);
+    tail->size = rest;
+    tail->prev_size = size;
+    tail->flags = 0;
+
+    heap_block_t* after = block_next(tail);
+    if((uint32_t)after < heap_pointer) {
+        after->prev_size = rest;
     }
-    return -1;
+    bin_insert(tail);
+}
+
+// === Bereich in eine Liste eintragen ===
+static void add_region(mem_region_t* list, int* count, int max, uint32_t start, uint32_t end) {
+    if(end <= start || *count >= max) return;
+    list[*count].start = start;
+    list[*count].end = end;
+    (*count)++;
 }
 
 // === Multiboot Memory Info ===
 void read_multiboot_info(uint32_t addr) {
     struct multiboot_info* mbi = (struct multiboot_info*)addr;
 
-    if (mbi->flags & 1) {  // Bit 0 gesetzt = mem_* gültig
-        total_memory = (mbi->mem_lower + mbi->mem_upper) * 1024;
-    } else {
-        total_memory = 16 * 1024 * 1024; // Fallback: 16 MB
+    mem_region_count = 0;
+    reserved_count = 0;
+    total_memory = 0;
+
+    if (mbi->flags & (1 << 6)) {  // Bit 6 gesetzt = mmap_* gültig
+        uint32_t entry = mbi->mmap_addr;
+        uint32_t mmap_end = mbi->mmap_addr + mbi->mmap_length;
+
+        while (entry < mmap_end) {
+            struct multiboot_mmap_entry* e = (struct multiboot_mmap_entry*)entry;
+
+            if (e->type == MULTIBOOT_MEMORY_AVAILABLE && e->addr < 0x100000000ULL) {
+                unsigned long long region_end = e->addr + e->len;
+                if (region_end > 0xFFFFF000ULL) region_end = 0xFFFFF000ULL;
+
+                uint32_t start = ((uint32_t)e->addr + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+                uint32_t end = (uint32_t)region_end & ~(PAGE_SIZE - 1);
+                if (end > start) {
+                    add_region(mem_regions, &mem_region_count, MAX_MEM_REGIONS, start, end);
+                    total_memory += end - start;
+                }
+            }
+            entry += e->size + sizeof(e->size);
+        }
+    }
+
+    if (mem_region_count == 0) {
+        if (mbi->flags & 1) {  // Bit 0 gesetzt = mem_* gültig
+            total_memory = (mbi->mem_lower + mbi->mem_upper) * 1024;
+        } else {
+            total_memory = 16 * 1024 * 1024; // Fallback: 16 MB
+        }
+        add_region(mem_regions, &mem_region_count, MAX_MEM_REGIONS, 0x100000, total_memory);
     }
 
-    // Kernel nimmt ersten 2 MB an (1MB - 3MB)
-    kernel_memory = 0x200000; // 2 MB
+    // Module (vom Bootloader hinter den Kernel geladen) nicht überschreiben
+    if (mbi->flags & (1 << 3)) {
+        struct multiboot_module* mods = (struct multiboot_module*)mbi->mods_addr;
+        for (uint32_t i = 0; i < mbi->mods_count; i++) {
+            add_region(reserved_regions, &reserved_count, MAX_RESERVED,
+                       mods[i].mod_start & ~(PAGE_SIZE - 1), mods[i].mod_end);
+        }
+    }
+
+    // Kernel-Image vom Linker (1 MB bis kernel_end inkl. .bss)
+    kernel_memory = (uint32_t)&kernel_end - 0x100000;
     used_memory = kernel_memory;
     free_memory = total_memory - used_memory;
 
     total_pages = total_memory / PAGE_SIZE;
     used_pages = used_memory / PAGE_SIZE;
-    free_pages = total_pages - used_pages;
+    free_page_count = total_pages - used_pages;
 }
 
-// === Page-Bitmap initialisieren ===
-static void init_page_bitmap(void) {
-    // Alle Seiten als frei markieren (1 = frei)
-    for(int i = 0; i < BITMAP_SIZE; i++) {
-        page_bitmap[i] = 0xFF;
-    }
+// === Freien Bereich ohne reservierte Teile an den Buddy-Allocator geben ===
+static void add_free_range(uint32_t start, uint32_t end, int first_reserved) {
+    for(int i = first_reserved; i < reserved_count; i++) {
+        mem_region_t* r = &reserved_regions[i];
+        if(r->end <= start || r->start >= end) continue;
 
-    // Kernel-Bereich (1MB - 3MB) als belegt markieren
-    uint32_t kernel_start = 0x100000;  // 1 MB
-    uint32_t kernel_end = 0x300000;    // 3 MB
+        // Überlappung: links und rechts davon getrennt weiter prüfen
+        if(r->start > start) add_free_range(start, r->start, i + 1);
+        if(r->end < end) add_free_range(r->end, end, i + 1);
+        return;
+    }
+    buddy_add_range(start, end);
+}
 
-    for(uint32_t addr = kernel_start; addr < kernel_end; addr += PAGE_SIZE) {
-        int page_idx = addr / PAGE_SIZE;
-        int byte_idx = page_idx / 8;
-        int bit_idx = page_idx % 8;
+// === Page-Bitmap + Buddy-Allocator initialisieren ===
+static void init_page_bitmap(void) {
+    // Alle Seiten als belegt markieren - der Buddy-Allocator gibt frei (1 = frei)
+    bitmap_clear_range((uint32_t*)page_bitmap, 0, BITMAP_SIZE * 8);
 
-        if(byte_idx < BITMAP_SIZE) {
-            page_bitmap[byte_idx] &= ~(1 << bit_idx);  // Bit löschen = belegt
-        }
+    // Höchste verwaltete Seite aus der Memory Map
+    uint32_t max_end = 0;
+    for(int i = 0; i < mem_region_count; i++) {
+        if(mem_regions[i].end > max_end) max_end = mem_regions[i].end;
     }
 
-    // VGA-Bereich (0xB8000 - 0xC0000) als belegt markieren
-    uint32_t vga_start = 0xB8000;
-    uint32_t vga_end = 0xC0000;
+    // frame_info des Buddy-Allocators direkt hinter den Kernel legen
+    uint32_t meta_start = ((uint32_t)&kernel_end + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    uint32_t meta_end = buddy_init(meta_start, max_end / PAGE_SIZE);
 
-    for(uint32_t addr = vga_start; addr < vga_end; addr += PAGE_SIZE) {
-        int page_idx = addr / PAGE_SIZE;
-        int byte_idx = page_idx / 8;
-        int bit_idx = page_idx % 8;
+    // Erstes MB (IVT, BIOS, VGA 0xB8000), Kernel + Metadaten, Heap-Fenster
+    add_region(reserved_regions, &reserved_count, MAX_RESERVED, 0, 0x100000);
+    add_region(reserved_regions, &reserved_count, MAX_RESERVED, 0x100000, meta_end);
+    add_region(reserved_regions, &reserved_count, MAX_RESERVED, HEAP_START, HEAP_END);
 
-        if(byte_idx < BITMAP_SIZE) {
-            page_bitmap[byte_idx] &= ~(1 << bit_idx);
-        }
+    for(int i = 0; i < mem_region_count; i++) {
+        add_free_range(mem_regions[i].start, mem_regions[i].end, 0);
     }
 
-    // Statistiken aktualisieren
-    used_pages = 0;
-    for(int i = 0; i < BITMAP_SIZE; i++) {
-        for(int bit = 0; bit < 8; bit++) {
-            if(!(page_bitmap[i] & (1 << bit))) {
-                used_pages++;
-            }
-        }
+    // Statistiken: frei = Buddy-Frames + (noch leeres) Heap-Fenster im RAM
+    free_page_count = buddy_free_frames();
+    for(int i = 0; i < mem_region_count; i++) {
+        uint32_t start = mem_regions[i].start > HEAP_START ? mem_regions[i].start : HEAP_START;
+        uint32_t end = mem_regions[i].end < HEAP_END ? mem_regions[i].end : HEAP_END;
+        if(end > start) free_page_count += (end - start) / PAGE_SIZE;
     }
-    free_pages = total_pages - used_pages;
+
+    used_pages = total_pages - free_page_count;
     used_memory = used_pages * PAGE_SIZE;
-    free_memory = free_pages * PAGE_SIZE;
+    free_memory = free_page_count * PAGE_SIZE;
+}
+
+// === Einzelne physische Seite (Order 0 beim Buddy-Allocator) ===
+void* alloc_page(void) {
+    return alloc_pages(0);
+}
+
+void free_page(void* page) {
+    free_pages(page, 0);
 }
 
 // === Heap-Initialisierung ===
@@ -157,84 +268,63 @@ void init_heap(void) {
     heap_pointer = HEAP_START;
     heap_end = HEAP_END;
 
-    // Allocation-Array initialisieren
-    for(int i = 0; i < MAX_ALLOCS; i++) {
-        allocations[i].ptr = NULL;
-        allocations[i].size = 0;
-        allocations[i].pages = 0;
-        allocations[i].used = 0;
-        allocations[i].aligned = 0;
-        allocations[i].file = NULL;
-        allocations[i].line = 0;
-        allocations[i].magic = 0;
+    // Free-Lists leeren
+    for(int i = 0; i < HEAP_BINS; i++) {
+        heap_bins[i] = NULL;
     }
+    heap_bin_map = 0;
+    heap_last_size = 0;
+    heap_free_blocks = 0;
+    heap_free_bytes = 0;
     alloc_count = 0;
 
     // Page-Bitmap initialisieren
     init_page_bitmap();
 
     // Erfolgsmeldung
-    kprint("Heap: ", 0x1F);  // White on blue
-    char buf[16];
-    hex_to_str(HEAP_START, buf);
-    kprint(buf, 0x2F);  // Green on blue
-    kprint(" - ", 0x1F);
-    hex_to_str(HEAP_END, buf);
-    kprint(buf, 0x2F);
-    kprint(" (", 0x1F);
-    int_to_str(HEAP_SIZE / (1024 * 1024), buf);
-    kprint(buf, 0x3F);  // Cyan on blue
-    kprint(" MB)\n", 0x1F);
+    klog(LOG_INFO, "Heap: %08X - %08X (%u MB)", HEAP_START, HEAP_END, HEAP_SIZE / (1024 * 1024));
 }
 
 // === malloc_debug (interne Funktion) ===
 static void* malloc_debug(uint32_t size, const char* file, int line) {
     if(size == 0) return NULL;
+    if(size > HEAP_SIZE) return NULL;
 
-    // Auf Block-Größe ausrichten
-    uint32_t original_size = size;
-    size = (size + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1);
-
-    // Prüfen ob genug Platz im Heap
-    if(heap_pointer + size > heap_end) {
-        kprint("HEAP OVERFLOW! ", 0x4F);  // Red on white
-        char buf[16];
-        int_to_str(size, buf);
-        kprint(buf, 0x4F);
-        kprint(" bytes\n", 0x4F);
-        return NULL;
-    }
+    // Auf Block-Größe ausrichten, Header dazu
+    size = ((size + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1)) + HEAP_HDR_SIZE;
+    if(size < HEAP_MIN_BLOCK) size = HEAP_MIN_BLOCK;
 
-    // Freien Slot finden
-    int slot = find_free_slot();
-    if(slot == -1) {
-        kprint("HEAP: No free allocation slots!\n", 0x4F);
-        return NULL;
+    // Erst freie Blöcke wiederverwenden
+    heap_block_t* block = find_free_block_fit(size);
+    if(block) {
+        bin_remove(block);
+        split_block(block, size);
+    } else {
+        // Sonst vom Ende des Heaps abschneiden
+        if(heap_pointer + size > heap_end) {
+            kprintf(0x4F, "HEAP OVERFLOW! %u bytes\n", size);  // Red on white
+            return NULL;
+        }
+
+        block = (heap_block_t*)heap_pointer;
+        block->size = size;
+        block->prev_size = heap_last_size;
+
+        heap_pointer += size;
+        heap_last_size = size;
     }
 
-    // Speicher allozieren
-    void* ptr = (void*)heap_pointer;
-    allocations[slot].ptr = ptr;
-    allocations[slot].size = size;
-    allocations[slot].pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
-    allocations[slot].used = 1;
-    allocations[slot].aligned = 0;
-    allocations[slot].file = file;
-    allocations[slot].line = line;
-    allocations[slot].magic = HEAP_MAGIC;
-
-    heap_pointer += size;
+    block->magic = HEAP_MAGIC;
+    block->flags = 0;
+
     alloc_count++;
-    used_memory += size;
-    free_memory -= size;
+    used_memory += block->size;
+    free_memory -= block->size;
 
     // Speicher mit 0xAA markieren (für Debug)
-    char* cptr = (char*)ptr;
-    for(uint32_t i = 0; i < size; i++) {
-        cptr[i] = 0xAA;
-    }
+    memset(block_to_ptr(block), 0xAA, block->size - HEAP_HDR_SIZE);
 
-    return ptr;
+    return block_to_ptr(block);
 }
 
 // === kmalloc_safe (öffentliche Funktion) ===
@@ -244,26 +334,27 @@ void* kmalloc_safe(uint32_t size) {
 
 // === Alignierte Allokation ===
 void* malloc_aligned(uint32_t size, uint32_t alignment) {
-    if(alignment < BLOCK_ALIGN) alignment = BLOCK_ALIGN;
+    if(alignment < BLOCK_SIZE) alignment = BLOCK_SIZE;
+    if(alignment & (alignment - 1)) return NULL;  // Nur Zweierpotenzen
 
-    // Extra Platz für Alignment + Header
-    uint32_t header_size = alignment + sizeof(void*);
-    uint8_t* raw = (uint8_t*)kmalloc_safe(size + header_size);
+    // Extra Platz für Alignment (Nutzbereich ist schon BLOCK_SIZE-aligned)
+    uint8_t* raw = (uint8_t*)kmalloc_safe(size + alignment - BLOCK_SIZE);
     if(!raw) return NULL;
 
     // Alignierten Zeiger berechnen
     uintptr_t raw_addr = (uintptr_t)raw;
     uintptr_t aligned = (raw_addr + alignment - 1) & ~(alignment - 1);
 
-    // Header vor dem aligned pointer speichern
-    ((uintptr_t*)aligned)[-1] = raw_addr;
+    block_from_ptr(raw)->flags |= HEAP_FLAG_ALIGNED;
 
-    // In allocations aligned flag setzen
-    for(int i = 0; i < MAX_ALLOCS; i++) {
-        if(allocations[i].ptr == raw) {
-            allocations[i].aligned = 1;
-            break;
-        }
+    // Tag-Header vor dem aligned pointer: Abstand zurück zum echten Block.
+    // aligned - raw ist >= BLOCK_SIZE, der Tag liegt also im Nutzbereich.
+    if(aligned != raw_addr) {
+        heap_block_t* tag = block_from_ptr((void*)aligned);
+        tag->magic = HEAP_ALIGN_MAGIC;
+        tag->size = 0;
+        tag->prev_size = aligned - raw_addr;
+        tag->flags = HEAP_FLAG_ALIGNED;
     }
 
     return (void*)aligned;
@@ -271,17 +362,33 @@ void* malloc_aligned(uint32_t size, uint32_t alignment) {
 
 // === calloc ===
 void* calloc(uint32_t num, uint32_t size) {
+    if(size != 0 && num > HEAP_SIZE / size) return NULL;  // Overflow
+
     uint32_t total = num * size;
     void* ptr = kmalloc_safe(total);
     if(ptr) {
-        char* cptr = (char*)ptr;
-        for(uint32_t i = 0; i < total; i++) {
-            cptr[i] = 0;
-        }
+        memset(ptr, 0, total);
     }
     return ptr;
 }
 
+// === Zeiger -> Block-Header (mit Prüfung) ===
+static heap_block_t* lookup_block(void* ptr) {
+    uintptr_t addr = (uintptr_t)ptr;
+    if(addr < HEAP_START + HEAP_HDR_SIZE || addr >= heap_pointer) return NULL;
+
+    heap_block_t* block = block_from_ptr(ptr);
+
+    // Zeiger von malloc_aligned? Dann zum echten Block zurück
+    if(block->magic == HEAP_ALIGN_MAGIC) {
+        addr -= block->prev_size;
+        if(addr < HEAP_START + HEAP_HDR_SIZE) return NULL;
+        block = block_from_ptr((void*)addr);
+    }
+
+    return block;
+}
+
 // === realloc ===
 void* realloc(void* ptr, uint32_t new_size) {
     if(!ptr) return kmalloc_safe(new_size);
@@ -290,18 +397,14 @@ void* realloc(void* ptr, uint32_t new_size) {
         return NULL;
     }
 
-    // Alte Größe finden
-    uint32_t old_size = 0;
-    int old_slot = -1;
-    for(int i = 0; i < MAX_ALLOCS; i++) {
-        if(allocations[i].used && allocations[i].ptr == ptr) {
-            old_size = allocations[i].size;
-            old_slot = i;
-            break;
-        }
-    }
+    heap_block_t* block = lookup_block(ptr);
+    if(!block || block->magic != HEAP_MAGIC) return NULL; // Ungültiger Pointer
 
-    if(old_size == 0) return NULL; // Ungültiger Pointer
+    // Passt noch in den alten Block? (nicht für alignierte Zeiger)
+    uint32_t old_size = block->size - HEAP_HDR_SIZE - ((uint8_t*)ptr - (uint8_t*)block_to_ptr(block));
+    if(new_size <= old_size && block_to_ptr(block) == ptr) {
+        return ptr;
+    }
 
     // Neuen Speicher allozieren
     void* new_ptr = kmalloc_safe(new_size);
@@ -309,11 +412,7 @@ void* realloc(void* ptr, uint32_t new_size) {
 
     // Daten kopieren
     uint32_t copy_size = (old_size < new_size) ? old_size : new_size;
-    char* src = (char*)ptr;
-    char* dst = (char*)new_ptr;
-    for(uint32_t i = 0; i < copy_size; i++) {
-        dst[i] = src[i];
-    }
+    memcpy(new_ptr, ptr, copy_size);
 
     // Alten Speicher freigeben
     kfree_safe(ptr);
@@ -325,51 +424,58 @@ void* realloc(void* ptr, uint32_t new_size) {
 void kfree_safe(void* ptr) {
     if(!ptr) return;
 
-    // Prüfen ob es ein alignierter Pointer ist
-    uintptr_t aligned_ptr = (uintptr_t)ptr;
-    uintptr_t raw_ptr = aligned_ptr;
+    heap_block_t* block = lookup_block(ptr);
+    if(!block) {
+        kprintf(0x1E, "WARNING: Free on unknown pointer %08X\n", (uint32_t)ptr);  // Yellow on blue
+        return;
+    }
 
-    // Gucken ob der Pointer von malloc_aligned kommt
-    for(int i = 0; i < MAX_ALLOCS; i++) {
-        if(allocations[i].used) {
-            if(allocations[i].ptr == ptr) {
-                raw_ptr = (uintptr_t)ptr;
-                break;
-            }
-            // Prüfen ob ptr im aligned Bereich liegt
-            if(allocations[i].aligned) {
-                uintptr_t start = (uintptr_t)allocations[i].ptr;
-                uintptr_t end = start + allocations[i].size;
-                if(aligned_ptr >= start && aligned_ptr < end) {
-                    raw_ptr = start;
-                    break;
-                }
-            }
-        }
+    // Magic Number prüfen
+    if(block->magic == HEAP_FREE_MAGIC) {
+        kprintf(0x1E, "WARNING: Double free %08X\n", (uint32_t)ptr);
+        return;
+    }
+    if(block->magic != HEAP_MAGIC) {
+        kprint("HEAP CORRUPTION DETECTED!\n", 0x4F);
+        return;
     }
 
-    // Slot finden und freigeben
-    for(int i = 0; i < MAX_ALLOCS; i++) {
-        if(allocations[i].used && (uintptr_t)allocations[i].ptr == raw_ptr) {
-            // Magic Number prüfen
-            if(allocations[i].magic != HEAP_MAGIC) {
-                kprint("HEAP CORRUPTION DETECTED!\n", 0x4F);
-                return;
-            }
+    alloc_count--;
+    used_memory -= block->size;
+    free_memory += block->size;
+
+    // Mit freiem Nachfolger verschmelzen
+    heap_block_t* next = block_next(block);
+    if((uint32_t)next < heap_pointer && next->magic == HEAP_FREE_MAGIC) {
+        bin_remove(next);
+        block->size += next->size;
+        next->magic = 0;            // Header liegt jetzt mitten im Block
+    }
 
-            allocations[i].used = 0;
-            alloc_count--;
-            used_memory -= allocations[i].size;
-            free_memory += allocations[i].size;
-            return;
+    // Mit freiem Vorgänger verschmelzen
+    if(block->prev_size != 0) {
+        heap_block_t* prev = block_prev(block);
+        if(prev->magic == HEAP_FREE_MAGIC) {
+            bin_remove(prev);
+            prev->size += block->size;
+            block->magic = 0;       // sonst gilt ein zweites kfree als gültig
+            block = prev;
         }
     }
 
-    kprint("WARNING: Free on unknown pointer ", 0x1E);  // Yellow on blue
-    char buf[16];
-    hex_to_str((uint32_t)ptr, buf);
-    kprint(buf, 0x1E);
-    kprint("\n", 0x1E);
+    block->flags = 0;
+
+    // Letzter Block? Dann einfach den Heap schrumpfen
+    next = block_next(block);
+    if((uint32_t)next >= heap_pointer) {
+        block->magic = 0;
+        heap_pointer = (uint32_t)block;
+        heap_last_size = block->prev_size;
+        return;
+    }
+
+    next->prev_size = block->size;
+    bin_insert(block);
 }
 
 // === Memory Info ausgeben ===
@@ -379,60 +485,42 @@ void print_memory_info(void) {
     kprint("║       MEMORY INFORMATION           ║\n", 0x03);
     kprint("╚════════════════════════════════════╝\n", 0x03);
 
-    char buf[32];
-
     uint32_t total_mb = total_memory / (1024 * 1024);
     uint32_t free_mb = free_memory / (1024 * 1024);
     uint32_t used_mb = used_memory / (1024 * 1024);
     uint32_t kernel_mb = kernel_memory / (1024 * 1024);
     uint32_t heap_mb = (heap_pointer - HEAP_START) / (1024 * 1024);
 
-    kprint(" Total RAM:  ", 0x07);
-    int_to_str(total_mb, buf);
-    kprint(buf, 0x03);
-    kprint(" MB\n", 0x07);
-
-    kprint(" Used:       ", 0x07);
-    int_to_str(used_mb, buf);
-    kprint(buf, 0x0E);
-    kprint(" MB\n", 0x07);
-
-    kprint(" Free:       ", 0x07);
-    int_to_str(free_mb, buf);
-    kprint(buf, 0x0A);
-    kprint(" MB\n", 0x07);
-
-    kprint(" Kernel:     ", 0x07);
-    int_to_str(kernel_mb, buf);
-    kprint(buf, 0x0D);
-    kprint(" MB\n", 0x07);
-
-    kprint(" Heap used:  ", 0x07);
-    int_to_str(heap_mb, buf);
-    kprint(buf, 0x03);
-    kprint(" MB\n", 0x07);
-
-    kprint(" Allocs:     ", 0x07);
-    int_to_str(alloc_count, buf);
-    kprint(buf, 0x03);
-    kprint("/", 0x07);
-    int_to_str(MAX_ALLOCS, buf);
-    kprint(buf, 0x08);
-    kprint("\n\n", 0x07);
+    kprintf(0x07, " Total RAM:  %C%u%C MB\n", 0x03, total_mb, 0x07);
+    kprintf(0x07, " Used:       %C%u%C MB\n", 0x0E, used_mb, 0x07);
+    kprintf(0x07, " Free:       %C%u%C MB\n", 0x0A, free_mb, 0x07);
+    kprintf(0x07, " Kernel:     %C%u%C MB\n", 0x0D, kernel_mb, 0x07);
+    kprintf(0x07, " Heap used:  %C%u%C MB\n", 0x03, heap_mb, 0x07);
+    kprintf(0x07, " Allocs:     %C%d\n\n", 0x03, alloc_count);
 }
 
 // === Heap Corruption Check ===
 void check_heap_corruption(void) {
     int corrupted = 0;
-    for(int i = 0; i < MAX_ALLOCS; i++) {
-        if(allocations[i].used && allocations[i].magic != HEAP_MAGIC) {
+    uint32_t prev_size = 0;
+
+    // Alle Blöcke physisch ablaufen
+    for(uint32_t addr = HEAP_START; addr < heap_pointer; ) {
+        heap_block_t* block = (heap_block_t*)addr;
+
+        int bad = (block->magic != HEAP_MAGIC && block->magic != HEAP_FREE_MAGIC) ||
+                  block->prev_size != prev_size ||
+                  block->size < HEAP_MIN_BLOCK || (block->size & (BLOCK_SIZE - 1)) ||
+                  addr + block->size > heap_pointer;
+
+        if(bad) {
             corrupted++;
-            kprint("Corrupted block at ", 0x04);
-            char buf[16];
-            hex_to_str((uint32_t)allocations[i].ptr, buf);
-            kprint(buf, 0x04);
-            kprint("\n", 0x04);
+            kprintf(0x04, "Corrupted block at %08X\n", addr);
+            break;  // Ohne gültige Größe kein weiterer Block erreichbar
         }
+
+        prev_size = block->size;
+        addr += block->size;
     }
 
     if(corrupted == 0) {
@@ -450,26 +538,19 @@ void memory_leak_check(void) {
     }
 
     kprint("Potential memory leaks:\n", 0x0E);
-    for(int i = 0; i < MAX_ALLOCS; i++) {
-        if(allocations[i].used) {
-            char buf[16];
-            kprint("  - ", 0x0E);
-            hex_to_str((uint32_t)allocations[i].ptr, buf);
-            kprint(buf, 0x03);
-            kprint(" (", 0x07);
-            int_to_str(allocations[i].size, buf);
-            kprint(buf, 0x07);
-            kprint(" bytes)", 0x07);
-
-            if(allocations[i].file) {
-                kprint(" at ", 0x07);
-                kprint((char*)allocations[i].file, 0x08);
-                kprint(":", 0x07);
-                int_to_str(allocations[i].line, buf);
-                kprint(buf, 0x08);
+    for(uint32_t addr = HEAP_START; addr < heap_pointer; ) {
+        heap_block_t* block = (heap_block_t*)addr;
+        if(block->size == 0) break;
+
+        if(block->magic == HEAP_MAGIC) {
+            kprintf(0x0E, "  - %C%08X%C (%u bytes)", 0x03, (uint32_t)block_to_ptr(block),
+                    0x07, block->size - HEAP_HDR_SIZE);
+            if(block->flags & HEAP_FLAG_ALIGNED) {
+                kprint(" [aligned]", 0x0A);
             }
             kprint("\n", 0x07);
         }
+        addr += block->size;
     }
 }
 
@@ -480,58 +561,34 @@ void debug_memory(void) {
     kprint("║          HEAP DEBUG                ║\n", 0x0D);
     kprint("╚════════════════════════════════════╝\n", 0x0D);
 
-    char buf[32];
-
-    kprint(" Heap start: 0x", 0x07);
-    hex_to_str(HEAP_START, buf);
-    kprint(buf, 0x03);
-    kprint("\n", 0x07);
-
-    kprint(" Heap ptr:   0x", 0x07);
-    hex_to_str(heap_pointer, buf);
-    kprint(buf, 0x0E);
-    kprint("\n", 0x07);
-
-    kprint(" Heap end:   0x", 0x07);
-    hex_to_str(heap_end, buf);
-    kprint(buf, 0x03);
-    kprint("\n", 0x07);
-
-    kprint(" Used:       ", 0x07);
-    int_to_str(used_memory / 1024, buf);
-    kprint(buf, 0x0E);
-    kprint(" KB\n", 0x07);
-
-    kprint(" Free:       ", 0x07);
-    int_to_str(free_memory / 1024, buf);
-    kprint(buf, 0x0A);
-    kprint(" KB\n", 0x07);
-
-    kprint(" Allocations: ", 0x07);
-    int_to_str(alloc_count, buf);
-    kprint(buf, 0x03);
-    kprint("\n\n", 0x07);
+    kprintf(0x07, " Heap start: 0x%C%08X\n", 0x03, HEAP_START);
+    kprintf(0x07, " Heap ptr:   0x%C%08X\n", 0x0E, heap_pointer);
+    kprintf(0x07, " Heap end:   0x%C%08X\n", 0x03, heap_end);
+    kprintf(0x07, " Used:       %C%u%C KB\n", 0x0E, used_memory / 1024, 0x07);
+    kprintf(0x07, " Free:       %C%u%C KB\n", 0x0A, free_memory / 1024, 0x07);
+    kprintf(0x07, " Allocations: %C%d\n", 0x03, alloc_count);
+    kprintf(0x07, " Free blocks: %C%u%C (%C%u%C KB reusable)\n\n",
+            0x0A, heap_free_blocks, 0x07, 0x0A, heap_free_bytes / 1024, 0x07);
 
     // Erste 10 Allokationen anzeigen
     if(alloc_count > 0) {
         kprint("Active allocations:\n", 0x08);
-        for(int i = 0; i < MAX_ALLOCS && i < 10; i++) {
-            if(allocations[i].used) {
-                kprint("  [", 0x08);
-                int_to_str(i, buf);
-                kprint(buf, 0x08);
-                kprint("] 0x", 0x08);
-                hex_to_str((uint32_t)allocations[i].ptr, buf);
-                kprint(buf, 0x03);
-                kprint(" (", 0x08);
-                int_to_str(allocations[i].size, buf);
-                kprint(buf, 0x07);
-                kprint(" bytes)", 0x08);
-                if(allocations[i].aligned) {
+        int shown = 0;
+        for(uint32_t addr = HEAP_START; addr < heap_pointer && shown < 10; ) {
+            heap_block_t* block = (heap_block_t*)addr;
+            if(block->size == 0) break;
+
+            if(block->magic == HEAP_MAGIC) {
+                kprintf(0x08, "  [%d] 0x%C%08X%C (%C%u%C bytes)", shown,
+                        0x03, (uint32_t)block_to_ptr(block), 0x08,
+                        0x07, block->size - HEAP_HDR_SIZE, 0x08);
+                if(block->flags & HEAP_FLAG_ALIGNED) {
                     kprint(" [aligned]", 0x0A);
                 }
                 kprint("\n", 0x08);
+                shown++;
             }
+            addr += block->size;
         }
         kprint("\n", 0x07);
     }
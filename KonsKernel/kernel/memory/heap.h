@@ -10,33 +10,51 @@
 
 #define BLOCK_SIZE      16
 #define BLOCK_ALIGN     8
-#define MAX_ALLOCS      8192
-#define HEAP_MAGIC      0xDEADBEEF
+#define HEAP_MAGIC      0xDEADBEEF  // Block belegt
+#define HEAP_FREE_MAGIC 0xFEEDFACE  // Block frei (in einer Free-List)
+#define HEAP_ALIGN_MAGIC 0xA11C0DED // Tag vor einem malloc_aligned Zeiger
+
+// === Free-List Konstanten ===
+#define HEAP_BINS       32          // Eine Liste pro Zweierpotenz (Bin = log2(Blockgröße))
+#define HEAP_MIN_BLOCK  32          // Header + next/prev Zeiger eines freien Blocks
+#define HEAP_BIN_PROBES 8           // Max. geprüfte Blöcke in der eigenen Bin
 
 // === Memory Management ===
 #define PAGE_SIZE       4096
-#define BITMAP_SIZE     8192       // Für 32MB Bitmap (8192*8*4096 = 256GB)
-
-// === Volle alloc_info Struktur (mit ALLEN Feldern) ===
-typedef struct alloc_info {
-    void* ptr;              // Zeiger auf allokierten Speicher
-    uint32_t size;          // Größe in Bytes
-    uint32_t pages;         // Anzahl belegter Seiten
-    uint8_t used;           // 1 = belegt, 0 = frei
-    uint8_t aligned;        // 1 = alignierte Allokation
-    const char* file;       // Dateiname für Debug
-    int line;               // Zeilennummer für Debug
-    uint32_t magic;         // Magic Number für Corruption-Check
-} alloc_info_t;
+#define BITMAP_SIZE     8192       // 8192*8 Seiten * 4096 = erste 256 MB
+#define MAX_MEM_REGIONS 32         // Verfügbare Bereiche aus der Multiboot Memory Map
+#define MAX_RESERVED    8          // Reservierte Bereiche (Kernel, Heap, Module...)
+
+// === Physischer Speicherbereich [start, end) ===
+typedef struct mem_region {
+    uint32_t start;
+    uint32_t end;
+} mem_region_t;
+
+// === Flags im Block-Header ===
+#define HEAP_FLAG_ALIGNED 0x01     // Block gehört zu einer malloc_aligned Allokation
+
+// === Block-Header (liegt direkt vor jedem Nutzbereich im Heap) ===
+// 16 Bytes groß, damit der Nutzbereich BLOCK_SIZE-aligned bleibt.
+typedef struct heap_block {
+    uint32_t magic;         // HEAP_MAGIC / HEAP_FREE_MAGIC / HEAP_ALIGN_MAGIC
+    uint32_t size;          // Blockgröße inkl. Header (Vielfaches von BLOCK_SIZE)
+    uint32_t prev_size;     // Größe des physischen Vorgängers (0 = erster Block)
+    uint32_t flags;         // HEAP_FLAG_*
+} heap_block_t;
+
+// === Freier Block: Free-List Zeiger liegen im (ungenutzten) Nutzbereich ===
+typedef struct heap_free_block {
+    heap_block_t header;
+    struct heap_free_block* next;
+    struct heap_free_block* prev;
+} heap_free_block_t;
 
 // === Externe Variablen ===
-extern alloc_info_t allocations[MAX_ALLOCS];
 extern int alloc_count;
-extern uint32_t heap_pointer;
+extern uint32_t heap_pointer;   // Obergrenze des bisher benutzten Heaps
 extern uint32_t heap_end;
 
-extern uint32_t heap_pointer;  // bleibt
-
 // === Memory Variablen ===
 extern uint32_t total_memory;
 extern uint32_t free_memory;
@@ -44,8 +62,10 @@ extern uint32_t used_memory;
 extern uint32_t kernel_memory;
 extern uint8_t page_bitmap[BITMAP_SIZE];
 extern uint32_t total_pages;
-extern uint32_t free_pages;
+extern uint32_t free_page_count;
 extern uint32_t used_pages;
+extern mem_region_t mem_regions[MAX_MEM_REGIONS];
+extern int mem_region_count;
 
 // === Basis-Funktionen ===
 void init_heap(void);
@@ -55,6 +75,10 @@ void print_memory_info(void);
 void debug_memory(void);
 void read_multiboot_info(uint32_t addr);
 
+// === Physische Seiten (Page-Bitmap) ===
+void* alloc_page(void);
+void free_page(void* page);
+
 // === Erweiterte Funktionen ===
 void* malloc_aligned(uint32_t size, uint32_t alignment);
 void* calloc(uint32_t num, uint32_t size);
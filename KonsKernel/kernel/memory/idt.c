@@ -2,23 +2,95 @@
 #include "idt.h"
 #include "isr.h"  // für isr_handler/irq_handle
 #include "../drivers/screen.h"
-#include "../drivers/keyboard.h"
 #include "../drivers/pic.h"
-#include "../drivers/mouse.h"
+#include "../drivers/apic.h"
 #include "../time/time.h"
-
-#define IDT_ENTRIES 256
+#include "../cpu/work.h"
+#include "../cpu/cpu.h"
+#include "../lib/printf.h"
 
 // IDT Tabellen - HIER werden sie definiert!
 struct idt_entry idt[IDT_ENTRIES];
 struct idt_ptr idtp;
 
-static void (*irq_handlers[16])(void) = {0};  // Array von Funktionspointern
+// ========================
+// HANDLER-TABELLE
+// ========================
+// Pro Vektor eine Kette - geteilte Leitungen hängen mehrere Handler an.
+// Einträge kommen aus einem festen Pool, registriert wird auch vor init_heap.
+#define IRQ_MAX_ACTIONS 64
+
+struct irq_action {
+    irq_handler_t fn;
+    void* ctx;
+    const char* name;
+    struct irq_action* next;
+};
+
+struct irq_stat {
+    uint32_t count;
+    uint32_t unhandled;     // kein Handler fühlte sich zuständig
+    uint32_t spurious;      // IRQ7/15 ohne gesetztes ISR-Bit
+    uint64_t cycles;        // TSC-Takte in den Handlern
+};
+
+static struct irq_action action_pool[IRQ_MAX_ACTIONS];
+static struct irq_action* free_actions = 0;
+static int pool_ready = 0;
+
+static struct irq_action* irq_actions[IDT_ENTRIES];
+static struct irq_stat irq_stats[IDT_ENTRIES];
+
+int irq_register(int vector, const char* name, irq_handler_t fn, void* ctx) {
+    if (vector < IRQ_BASE || vector >= IDT_ENTRIES || !fn) return 0;
+
+    uint32_t flags = irq_save();
+
+    if (!pool_ready) {
+        for (int i = 0; i < IRQ_MAX_ACTIONS; i++) {
+            action_pool[i].next = free_actions;
+            free_actions = &action_pool[i];
+        }
+        pool_ready = 1;
+    }
+
+    struct irq_action* a = free_actions;
+    if (!a) {
+        irq_restore(flags);
+        return 0;
+    }
+    free_actions = a->next;
+
+    a->fn = fn;
+    a->ctx = ctx;
+    a->name = name;
+    a->next = 0;
 
-void irq_install_handler(int irq, void (*handler)(void)) {
-    if (irq >= 0 && irq < 16) {
-        irq_handlers[irq] = handler;  // ← Jetzt funktioniert '='
+    // Hinten anhängen: Reihenfolge der Registrierung = Aufrufreihenfolge
+    struct irq_action** link = &irq_actions[vector];
+    while (*link) link = &(*link)->next;
+    *link = a;
+
+    irq_restore(flags);
+    return 1;
+}
+
+void irq_unregister(int vector, irq_handler_t fn, void* ctx) {
+    if (vector < 0 || vector >= IDT_ENTRIES) return;
+
+    uint32_t flags = irq_save();
+    struct irq_action** link = &irq_actions[vector];
+    while (*link) {
+        struct irq_action* a = *link;
+        if (a->fn == fn && a->ctx == ctx) {
+            *link = a->next;
+            a->next = free_actions;
+            free_actions = a;
+            break;
+        }
+        link = &a->next;
     }
+    irq_restore(flags);
 }
 
 
@@ -49,107 +121,184 @@ void isr_install(void) {
         idt_set_gate(i, 0, 0, 0);
     }
 
-    // CPU Exceptions (0-31)
-    idt_set_gate(0, (unsigned long)_isr0, 0x08, 0x8E);
-    idt_set_gate(1, (unsigned long)_isr1, 0x08, 0x8E);
-    idt_set_gate(2, (unsigned long)_isr2, 0x08, 0x8E);
-    // ... bis 31
-    idt_set_gate(31, (unsigned long)_isr31, 0x08, 0x8E);
-
-    // Hardware IRQs (32-47)
-    idt_set_gate(32, (unsigned long)_irq0, 0x08, 0x8E);
-    idt_set_gate(33, (unsigned long)_irq1, 0x08, 0x8E);
-    // ... bis 47
-    idt_set_gate(47, (unsigned long)_irq15, 0x08, 0x8E);
+    // Alle Vektoren: 0-31 Exceptions, 32-47 PIC, 48-255 APIC/MSI/Software
+    for(int i = 0; i < IDT_ENTRIES; i++) {
+        idt_set_gate(i, isr_stub_table[i], 0x08, 0x8E);
+    }
 
     // Load IDT
     asm volatile("lidt (%0)" : : "r" (&idtp));
 }
 
-void irq_install(void) {
-    // Mask ALL interrupts first
-    outb(0x21, 0xFF);
-    outb(0xA1, 0xFF);
+// ========================
+// VEKTOR-VERGABE (MSI/MSI-X)
+// ========================
+// Freie Vektoren oberhalb der ISA-IRQs. Blöcke sind auf ihre Größe
+// ausgerichtet - Multi-Message-MSI ersetzt die unteren Bits der Nachricht.
+static uint32_t vector_used[IDT_ENTRIES / 32];
 
-    // Unmask only Timer (IRQ0) and Keyboard (IRQ1)
-    outb(0x21, 0xFC);
-    outb(0xA1, 0xFF);
+static int vector_is_used(int v) {
+    return vector_used[v / 32] & (1u << (v % 32));
 }
 
-void irq_handler(struct regs *r) {
-    unsigned char irq_num = r->int_no - 32;
+int irq_alloc_vectors(int count) {
+    if (count < 1 || count > 32 || (count & (count - 1))) return -1;
+
+    uint32_t flags = irq_save();
+    int start = (IRQ_DYN_FIRST + count - 1) & ~(count - 1);
+    for (int first = start; first + count - 1 <= IRQ_DYN_LAST; first += count) {
+        int free = 1;
+        for (int v = first; v < first + count; v++) {
+            if (vector_is_used(v)) {
+                free = 0;
+                break;
+            }
+        }
+        if (!free) continue;
 
-    // Updated!
-    if (irq_num == 0) {
+        for (int v = first; v < first + count; v++) {
+            vector_used[v / 32] |= 1u << (v % 32);
+        }
+        irq_restore(flags);
+        return first;
+    }
+    irq_restore(flags);
+    return -1;
+}
 
-        static uint32_t timer_ticks = 0;
-        timer_ticks++;
+void irq_free_vectors(int first, int count) {
+    uint32_t flags = irq_save();
+    for (int v = first; v < first + count && v < IDT_ENTRIES; v++) {
+        vector_used[v / 32] &= ~(1u << (v % 32));
+    }
+    irq_restore(flags);
+}
 
-        // ungefähr 1x pro Sekunde
-        if (timer_ticks % 18 == 0) {
+// ========================
+// BOTTOM HALVES
+// ========================
+// Uhr in der Statuszeile - läuft als Deferred Work, nicht mehr im Timer-IRQ
+// Schreibt direkt in die Statuszeile: keine Cursor-Globals, die eine
+// unterbrochene kwrite-Ausgabe gerade benutzt
+static void clock_work_fn(void* arg) {
+    int h, m, s;
+    get_time(&h, &m, &s);
+
+    char buf[9];
+    ksnprintf(buf, sizeof(buf), "%02d:%02d:%02d", h, m, s);
+
+    kprint_at("GMT ", 68, 0, COLOR_CYAN_ON_BLUE);
+    kprint_at(buf, 72, 0, COLOR_WHITE_ON_BLUE);
+}
 
-            int old_x = cursor_x;
-            int old_y = cursor_y;
+// Ausgaben außerhalb von IRQs spätestens nach einem Tick sichtbar
+static void flush_work_fn(void* arg) {
+    screen_flush();
+}
 
-            set_cursor(68, 0);
+static struct work clock_work;
+static struct work flush_work;
 
-            int h, m, s;
-            get_time(&h, &m, &s);
+// Timer: nur zählen und einreihen
+static int timer_irq(void* ctx) {
+    static uint32_t timer_ticks = 0;
+    timer_ticks++;
 
-            char buf[9];
+    // ungefähr 1x pro Sekunde
+    if (timer_ticks % 18 == 0) schedule_work(&clock_work);
+    schedule_work(&flush_work);
+    return IRQ_HANDLED;
+}
 
-            buf[0] = '0' + (h / 10);
-            buf[1] = '0' + (h % 10);
-            buf[2] = ':';
-            buf[3] = '0' + (m / 10);
-            buf[4] = '0' + (m % 10);
-            buf[5] = ':';
-            buf[6] = '0' + (s / 10);
-            buf[7] = '0' + (s % 10);
-            buf[8] = '\0';
+void irq_install(void) {
+    work_init(&clock_work, "clock", 0, clock_work_fn, 0);
+    work_init(&flush_work, "screen", 0, flush_work_fn, 0);
 
-            kprint("GMT ", COLOR_CYAN_ON_BLUE);
-            kprint(buf, COLOR_WHITE_ON_BLUE);
-            kprint("  ", COLOR_CYAN_ON_BLUE);
+    // Mask ALL interrupts first
+    outb(0x21, 0xFF);
+    outb(0xA1, 0xFF);
 
-            set_cursor(old_x, old_y);
-        }
+    // Timer hier, alle anderen Leitungen gibt ihr Treiber frei (keyboard_init, ...)
+    irq_register(IRQ_BASE + 0, "timer", timer_irq, 0);
+    irq_unmask(0);
+}
 
-        pic_send_eoi(irq_num);
-    }
+// ========================
+// CONTROLLER (PIC oder IOAPIC)
+// ========================
+void irq_mask(int irq) {
+    if (irq < 0 || irq >= 16) return;
+    if (apic_active()) apic_irq_mask(irq);
+    else pic_mask(irq);
+}
 
-    // Keyboard - NUR den Aufruf, der Code bleibt in keyboard.c!
-    else if (irq_num == 1) {
-        unsigned char scancode = inb(0x60);
-
-        if (debug_mode) {
-            kprint("[", COLOR_YELLOW_ON_BLUE);
-            if (scancode & 0x80) kprint("BRK:", COLOR_RED_ON_BLUE);
-            else kprint("MAK:", COLOR_GREEN_ON_BLUE);
-
-            char hex[3];
-            hex[0] = "0123456789ABCDEF"[(scancode >> 4) & 0xF];
-            hex[1] = "0123456789ABCDEF"[scancode & 0xF];
-            hex[2] = '\0';
-            kprint(hex, COLOR_WHITE_ON_BLUE);
-            kprint("]", COLOR_YELLOW_ON_BLUE);
-        }
+void irq_unmask(int irq) {
+    if (irq < 0 || irq >= 16) return;
+    if (apic_active()) apic_irq_unmask(irq);
+    else pic_unmask(irq);
+}
 
-        // Hier rufst du später deine keyboard_handler() auf!
-        keyboard_handler();
+// Mit APIC ein MMIO-Schreibzugriff, sonst Port-I/O an einen oder beide PICs
+static inline void irq_eoi(uint32_t vector) {
+    if (apic_active()) lapic_eoi();
+    else if (vector >= IRQ_BASE && vector < IRQ_BASE + 16) pic_send_eoi(vector - IRQ_BASE);
+}
 
-        pic_send_eoi(irq_num);
+// ========================
+// DISPATCH
+// ========================
+void irq_handler(struct regs *r) {
+    uint32_t vector = r->int_no;
+    struct irq_stat* stat = &irq_stats[vector];
+
+    // Störimpulse: IRQ7/15 ohne ISR-Bit beim PIC, Spurious-Vektor beim LAPIC.
+    // Kein Handler und kein (volles) EOI.
+    if (apic_active()) {
+        if (vector == APIC_SPURIOUS_VECTOR) {
+            stat->spurious++;
+            return;
+        }
+    } else if ((vector == IRQ_BASE + 7 || vector == IRQ_BASE + 15) &&
+               pic_spurious(vector - IRQ_BASE)) {
+        stat->spurious++;
+        return;
     }
-    // Andere IRQs
-    else {
-        pic_send_eoi(irq_num);
+
+    // Ohne TSC wäre rdtsc #UD - dann bleibt die Zyklen-Statistik bei 0
+    uint64_t start = cpu.tsc ? rdtsc() : 0;
+    int handled = IRQ_NONE;
+    for (struct irq_action* a = irq_actions[vector]; a; a = a->next) {
+        handled |= a->fn(a->ctx);
     }
+    if (cpu.tsc) stat->cycles += rdtsc() - start;
+    stat->count++;
+    if (!handled) stat->unhandled++;
+
+    irq_eoi(vector);
+
+    // EOI ist raus - Bottom Halves mit offenen Interrupts abarbeiten
+    work_irq_exit();
 }
 
+void irq_print_stats(void) {
+    kprint("\n=== Interrupts ===\n", TXT_INFO);
+    kprintf(TXT_NORMAL, "Controller: %C%s%C\n", TXT_CYAN,
+            apic_active() ? "Local APIC + IOAPIC" : "8259 PIC", TXT_NORMAL);
+    kprint("Vec  IRQ      Count  Unhandled  Avg cycles  Handlers\n", TXT_NORMAL);
+
+    for (int v = IRQ_BASE; v < IDT_ENTRIES; v++) {
+        struct irq_stat* stat = &irq_stats[v];
+        if (!irq_actions[v] && !stat->count && !stat->spurious) continue;
 
+        uint32_t avg = stat->count ? (uint32_t)div64_32(stat->cycles, stat->count) : 0;
+        if (v < IRQ_BASE + 16) kprintf(TXT_NORMAL, "%3d  %3d", v, v - IRQ_BASE);
+        else kprintf(TXT_NORMAL, "%3d    -", v);
+        kprintf(TXT_NORMAL, " %10u  %9u  %10u  ", stat->count, stat->unhandled, avg);
 
-// IRQ12 = Maus
-void irq12_handler(void) {
-    mouse_handler();
-    pic_send_eoi(12); // Ende des Interrupts
+        for (struct irq_action* a = irq_actions[v]; a; a = a->next) {
+            kprintf(TXT_CYAN, "%s%s", a->name, a->next ? "," : "");
+        }
+        if (stat->spurious) kprintf(TXT_WARNING, " (%u spurious)", stat->spurious);
+        kprint("\n", TXT_NORMAL);
+    }
 }
@@ -24,6 +24,35 @@ void idt_set_gate(unsigned char num, unsigned long base, unsigned short sel, uns
 void isr_install(void);  // ← in idt.c!
 void irq_install(void);  // ← in idt.c!
 
+// ========================
+// IRQ-DISPATCH
+// ========================
+#define IRQ_BASE        32      // Vektor von IRQ 0 (PIC nach pic_remap)
+#define IRQ_NONE        0
+#define IRQ_HANDLED     1
+
+// Rückgabe IRQ_HANDLED, wenn das eigene Gerät den Interrupt ausgelöst hat
+typedef int (*irq_handler_t)(void* ctx);
+
+// Handler an einen Vektor (>= IRQ_BASE) hängen. Mehrere Handler pro Vektor
+// werden nacheinander aufgerufen (geteilte Leitungen). 0 = Pool voll.
+int irq_register(int vector, const char* name, irq_handler_t fn, void* ctx);
+void irq_unregister(int vector, irq_handler_t fn, void* ctx);
+
+// Zusammenhängende, auf count ausgerichtete Vektoren für MSI/MSI-X
+// (count = Zweierpotenz bis 32). Rückgabe erster Vektor oder -1.
+#define IRQ_DYN_FIRST   (IRQ_BASE + 16)
+#define IRQ_DYN_LAST    0xEF            // darüber: APIC (Spurious 0xFF)
+int irq_alloc_vectors(int count);
+void irq_free_vectors(int first, int count);
+
+// ISA-IRQ-Leitung (0-15) sperren / freigeben - am PIC oder IOAPIC
+void irq_mask(int irq);
+void irq_unmask(int irq);
+
+// Aufrufe, Takte und unbehandelte/falsche Interrupts pro Vektor
+void irq_print_stats(void);
+
 // Externe Variablen
 extern struct idt_entry idt[IDT_ENTRIES];
 extern struct idt_ptr idtp;
@@ -42,6 +71,9 @@ extern void _isr20(void); extern void _isr21(void); extern void _isr22(void); ex
 extern void _isr24(void); extern void _isr25(void); extern void _isr26(void); extern void _isr27(void);
 extern void _isr28(void); extern void _isr29(void); extern void _isr30(void); extern void _isr31(void);
 
+// Alle 256 Einstiegspunkte in Vektor-Reihenfolge (_isr0-31, _irq0-223)
+extern uint32_t isr_stub_table[IDT_ENTRIES];
+
 // Hardware IRQs (32-47) - DAS HIER HAT GEFEHLT!
 extern void _irq0(void);  extern void _irq1(void);  extern void _irq2(void);  extern void _irq3(void);
 extern void _irq4(void);  extern void _irq5(void);  extern void _irq6(void);  extern void _irq7(void);
@@ -4,6 +4,10 @@
 #include "../drivers/pic.h"
 #include "../kernel.h"          // ← für struct regs
 #include "../drivers/keyboard.h"
+#include "../cpu/fpu.h"
+#include "../cpu/cpu.h"
+#include "../drivers/serial.h"
+#include "../lib/printf.h"
 
 #define COLOR_YELLOW        0x0E
 #define COLOR_YELLOW_ON_BLUE ((THEME_BACKGROUND << 4) | COLOR_YELLOW)
@@ -29,20 +33,33 @@ void isr_handler(struct regs *r) {
         return;
     }
 
-    // CPU Exception
-    kprint("\n[CPU EXCEPTION] INT 0x", COLOR_RED_ON_BLUE);
+    // Device Not Available: FPU-Zustand nachladen und weiter
+    if (r->int_no == 7) {
+        fpu_handle_nm();
+        return;
+    }
 
-    char hex[5];
-    hex[0] = '0';
-    hex[1] = 'x';
-    hex[2] = "0123456789ABCDEF"[(r->int_no >> 4) & 0xF];
-    hex[3] = "0123456789ABCDEF"[r->int_no & 0xF];
-    hex[4] = '\0';
-    kprint(hex, COLOR_WHITE_ON_BLUE);
+    // CPU Exception
+    kprintf(COLOR_RED_ON_BLUE, "\n[CPU EXCEPTION] INT %C0x%02X%C",
+            COLOR_WHITE_ON_BLUE, r->int_no, COLOR_RED_ON_BLUE);
 
     if (r->int_no == 0) kprint(" (Division by zero)\n", COLOR_RED_ON_BLUE);
     else if (r->int_no == 8) kprint(" (Double Fault)\n", COLOR_RED_ON_BLUE);
     else if (r->int_no == 13) kprint(" (General Protection)\n", COLOR_RED_ON_BLUE);
-    else if (r->int_no == 14) kprint(" (Page Fault)\n", COLOR_RED_ON_BLUE);
+    else if (r->int_no == 14) {
+        // Zurückkehren würde denselben Zugriff endlos wiederholen
+        kprintf(COLOR_RED_ON_BLUE, " (Page Fault) at %C0x%08X%C",
+                COLOR_WHITE_ON_BLUE, read_cr2(), COLOR_RED_ON_BLUE);
+        kprint(r->err_code & 1 ? " protection" : " not present", COLOR_RED_ON_BLUE);
+        kprint(r->err_code & 2 ? " write\n" : " read\n", COLOR_RED_ON_BLUE);
+        kprint("System halted.\n", COLOR_RED_ON_BLUE);
+        screen_flush();
+        serial_flush();
+        asm volatile("cli");
+        while (1) asm volatile("hlt");
+    }
+    else if (r->int_no == 19) kprint(" (SIMD Floating-Point)\n", COLOR_RED_ON_BLUE);
     else kprint("\n", COLOR_RED_ON_BLUE);
+
+    screen_flush();
 }
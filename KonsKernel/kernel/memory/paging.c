@@ -0,0 +1,276 @@
+// kernel/memory/paging.c - Paging: Identity-Mapping mit 4 MB Seiten, 4 KB Tabellen bei Bedarf
+#include "paging.h"
+#include "heap.h"
+#include "../cpu/cpu.h"
+#include "../drivers/screen.h"
+#include "../lib/printf.h"
+#include "../lib/mem.h"
+#include "../lib/utils.h"
+
+// Page Directory + Tabelle für die ersten 4 MB (BIOS, VGA, Kernel)
+static uint32_t page_directory[1024] __attribute__((aligned(4096)));
+static uint32_t low_table[1024] __attribute__((aligned(4096)));
+
+static int paging_on = 0;
+static int pat_wc = 0;                // PAT Eintrag 1 ist Write-Combining
+static uint32_t identity_pdes = 0;    // so viele 4 MB Bereiche sind RAM-Identity-Map
+
+// === Gesammelte invlpg - ein Flush pro Mapping-Vorgang ===
+#define INVLPG_BATCH 32
+static uint32_t invlpg_pending[INVLPG_BATCH];
+static int invlpg_count = 0;
+static int invlpg_overflow = 0;      // zu viele: ganzen TLB per CR3 leeren
+
+// Statistik
+static uint32_t large_pages = 0;
+static uint32_t page_tables = 0;
+static uint32_t large_splits = 0;
+static uint32_t tlb_flushes = 0;
+
+static inline void invlpg(uint32_t addr) {
+    asm volatile("invlpg (%0)" : : "r"(addr) : "memory");
+}
+
+static void queue_invlpg(uint32_t virt) {
+    if(!paging_on) return;
+    if(invlpg_count < INVLPG_BATCH) invlpg_pending[invlpg_count++] = virt;
+    else invlpg_overflow = 1;
+}
+
+void paging_flush(void) {
+    if(invlpg_overflow) {
+        write_cr3(read_cr3());
+    } else {
+        for(int i = 0; i < invlpg_count; i++) {
+            invlpg(invlpg_pending[i]);
+        }
+    }
+    if(invlpg_count || invlpg_overflow) tlb_flushes++;
+    invlpg_count = 0;
+    invlpg_overflow = 0;
+}
+
+// === 4 MB Seite in eine Tabelle mit gleichen Attributen aufteilen ===
+static uint32_t* split_large_page(uint32_t pdi) {
+    uint32_t pde = page_directory[pdi];
+    uint32_t* table = (uint32_t*)alloc_page();
+    if(!table) return NULL;
+
+    uint32_t base = pde & LARGE_PAGE_FRAME;
+    uint32_t flags = pde & (PAGE_WRITE | PAGE_USER | PAGE_PWT | PAGE_PCD | PAGE_GLOBAL);
+    if(pde & PAGE_LARGE_PAT) flags |= PAGE_PAT;
+
+    for(int i = 0; i < 1024; i++) {
+        table[i] = (base + i * PAGE_SIZE) | flags | PAGE_PRESENT;
+    }
+
+    page_directory[pdi] = (uint32_t)table | PAGE_PRESENT | PAGE_WRITE;
+    queue_invlpg(base);     // invalidiert den 4 MB TLB-Eintrag
+
+    large_pages--;
+    large_splits++;
+    page_tables++;
+    return table;
+}
+
+// === Tabelle für virt holen, bei Bedarf anlegen oder 4 MB Seite aufteilen ===
+static uint32_t* get_table(uint32_t virt, int create) {
+    uint32_t pdi = virt >> 22;
+    uint32_t pde = page_directory[pdi];
+
+    if(pde & PAGE_PRESENT) {
+        if(pde & PAGE_LARGE) return create ? split_large_page(pdi) : NULL;
+        return (uint32_t*)(pde & PAGE_FRAME);
+    }
+    if(!create) return NULL;
+
+    uint32_t* table = (uint32_t*)alloc_page();
+    if(!table) return NULL;
+    memset(table, 0, PAGE_SIZE);
+
+    page_directory[pdi] = (uint32_t)table | PAGE_PRESENT | PAGE_WRITE;
+    page_tables++;
+    return table;
+}
+
+// === PAT umprogrammieren (Intel SDM: Caches aus, wbinvd, MSR, wbinvd, TLB) ===
+static void pat_init(void) {
+    if(!cpu.pat || !cpu.msr) return;
+
+    uint32_t flags = irq_save();
+
+    uint32_t cr0 = read_cr0();
+    write_cr0((cr0 | CR0_CD) & ~CR0_NW);
+    asm volatile("wbinvd" : : : "memory");
+
+    wrmsr(MSR_PAT, PAT_VALUE);
+
+    asm volatile("wbinvd" : : : "memory");
+    write_cr3(read_cr3());
+    write_cr0(cr0);
+
+    irq_restore(flags);
+    pat_wc = 1;
+}
+
+// Cache-Bits für den Typ (PTE und 4 MB PDE: PAT-Index 1 = PWT)
+static uint32_t mmio_cache_flags(int type) {
+    // Ohne PAT gibt es kein WC - UC ist die sichere Wahl
+    if(type == MMIO_WC && pat_wc) return PAGE_PWT;
+    return PAGE_PCD | PAGE_PWT;
+}
+
+// ========================
+// INIT
+// ========================
+void paging_init(void) {
+    // RAM + Heap-Fenster identity mappen (Heap darf über das RAM hinaus zeigen)
+    uint32_t top = HEAP_END;
+    for(int i = 0; i < mem_region_count; i++) {
+        if(mem_regions[i].end > top) top = mem_regions[i].end;
+    }
+    identity_pdes = ((top - 1) >> 22) + 1;
+
+    memset(page_directory, 0, sizeof(page_directory));
+
+    // Erste 4 MB in 4 KB Seiten: VGA und BIOS-ROM bekommen eigene Attribute
+    for(int i = 0; i < 1024; i++) {
+        low_table[i] = (i * PAGE_SIZE) | PAGE_PRESENT | PAGE_WRITE;
+    }
+    pat_init();
+    for(uint32_t addr = 0xA0000; addr < 0xC0000; addr += PAGE_SIZE) {
+        low_table[addr / PAGE_SIZE] |= PAGE_PCD | PAGE_PWT;
+    }
+
+    // Textpuffer Write-Combining: Zeichen werden zu ganzen Cache-Lines gebündelt
+    for(uint32_t addr = VIDEO_MEMORY; addr < VIDEO_MEMORY + VIDEO_MEMORY_SIZE; addr += PAGE_SIZE) {
+        low_table[addr / PAGE_SIZE] &= ~(PAGE_PCD | PAGE_PWT);
+        low_table[addr / PAGE_SIZE] |= mmio_cache_flags(MMIO_WC);
+    }
+    page_directory[0] = (uint32_t)low_table | PAGE_PRESENT | PAGE_WRITE;
+    page_tables = 1;
+
+    if(cpu.pse) {
+        // Rest als 4 MB Seiten - kein Tabellenspeicher, ein TLB-Eintrag pro 4 MB
+        write_cr4(read_cr4() | CR4_PSE);
+        for(uint32_t pdi = 1; pdi < identity_pdes; pdi++) {
+            page_directory[pdi] = (pdi << 22) | PAGE_PRESENT | PAGE_WRITE | PAGE_LARGE;
+            large_pages++;
+        }
+    } else {
+        // Ohne PSE: 4 KB Tabellen aus dem Buddy-Allocator
+        for(uint32_t pdi = 1; pdi < identity_pdes; pdi++) {
+            uint32_t* table = (uint32_t*)alloc_page();
+            if(!table) {
+                identity_pdes = pdi;
+                break;
+            }
+            for(int i = 0; i < 1024; i++) {
+                table[i] = ((pdi << 22) + i * PAGE_SIZE) | PAGE_PRESENT | PAGE_WRITE;
+            }
+            page_directory[pdi] = (uint32_t)table | PAGE_PRESENT | PAGE_WRITE;
+            page_tables++;
+        }
+    }
+
+    write_cr3((uint32_t)page_directory);
+    write_cr0(read_cr0() | CR0_PG);
+    paging_on = 1;
+}
+
+int paging_enabled(void) {
+    return paging_on;
+}
+
+int paging_wc_enabled(void) {
+    return pat_wc;
+}
+
+// ========================
+// MAP / UNMAP
+// ========================
+int map_page(uint32_t virt, uint32_t phys, uint32_t flags) {
+    uint32_t* table = get_table(virt, 1);
+    if(!table) return -1;
+
+    table[(virt >> 12) & 0x3FF] = (phys & PAGE_FRAME) | (flags & ~PAGE_FRAME) | PAGE_PRESENT;
+    queue_invlpg(virt);
+    return 0;
+}
+
+void unmap_page(uint32_t virt) {
+    if(!(page_directory[virt >> 22] & PAGE_PRESENT)) return;
+
+    uint32_t* table = get_table(virt, 1);
+    if(!table) return;
+
+    table[(virt >> 12) & 0x3FF] = 0;
+    queue_invlpg(virt);
+}
+
+uint32_t virt_to_phys(uint32_t virt) {
+    uint32_t pde = page_directory[virt >> 22];
+    if(!paging_on) return virt;
+    if(!(pde & PAGE_PRESENT)) return PAGING_NO_MAPPING;
+    if(pde & PAGE_LARGE) return (pde & LARGE_PAGE_FRAME) | (virt & (LARGE_PAGE_SIZE - 1));
+
+    uint32_t pte = ((uint32_t*)(pde & PAGE_FRAME))[(virt >> 12) & 0x3FF];
+    if(!(pte & PAGE_PRESENT)) return PAGING_NO_MAPPING;
+    return (pte & PAGE_FRAME) | (virt & (PAGE_SIZE - 1));
+}
+
+// ========================
+// MMIO
+// ========================
+
+void* map_mmio(uint32_t phys, uint32_t size, int type) {
+    if(size == 0) return NULL;
+    if(!paging_on) return (void*)phys;
+
+    uint32_t addr = phys & PAGE_FRAME;
+    uint32_t last = (phys + size - 1) & PAGE_FRAME;
+    uint32_t cache = mmio_cache_flags(type);
+
+    while(1) {
+        uint32_t pdi = addr >> 22;
+        uint32_t pde = page_directory[pdi];
+
+        // Ganzer, ausgerichteter 4 MB Bereich ohne bestehende Tabelle: eine PDE
+        if(cpu.pse && (addr & (LARGE_PAGE_SIZE - 1)) == 0 &&
+           last - addr >= LARGE_PAGE_SIZE - PAGE_SIZE &&
+           (!(pde & PAGE_PRESENT) || (pde & PAGE_LARGE))) {
+            if(!(pde & PAGE_PRESENT)) large_pages++;
+            page_directory[pdi] = addr | PAGE_PRESENT | PAGE_WRITE | PAGE_LARGE | cache;
+            queue_invlpg(addr);
+            if(last - addr == LARGE_PAGE_SIZE - PAGE_SIZE) break;
+            addr += LARGE_PAGE_SIZE;
+            continue;
+        }
+
+        if(map_page(addr, addr, PAGE_WRITE | cache) != 0) break;
+        if(addr == last) break;
+        addr += PAGE_SIZE;
+    }
+
+    paging_flush();
+    return (void*)phys;
+}
+
+// ========================
+// INFO
+// ========================
+void paging_info(void) {
+    kprint("\n=== Paging ===\n", TXT_INFO);
+    kprintf(TXT_NORMAL, "Status:        %C%s%C%s\n", paging_on ? TXT_SUCCESS : TXT_ERROR,
+            paging_on ? "enabled" : "disabled", TXT_GRAY,
+            cpu.pse ? " (PSE 4 MB pages)" : " (4 KB pages only)");
+    kprintf(TXT_NORMAL, "PAT:           %C%s\n", pat_wc ? TXT_SUCCESS : TXT_WARNING,
+            pat_wc ? "WC at index 1 (VGA text buffer WC)" : "not available (MMIO uncached)");
+
+    if(identity_pdes >= 1024) kprintf(TXT_NORMAL, "Identity map:  0x0 - %C4 GB\n", TXT_CYAN);
+    else kprintf(TXT_NORMAL, "Identity map:  0x0 - %C%X\n", TXT_CYAN, identity_pdes << 22);
+    kprintf(TXT_NORMAL, "4 MB pages:    %C%u\n", TXT_CYAN, large_pages);
+    kprintf(TXT_NORMAL, "Page tables:   %C%u\n", TXT_CYAN, page_tables);
+    kprintf(TXT_NORMAL, "Splits:        %C%u\n", TXT_CYAN, large_splits);
+    kprintf(TXT_NORMAL, "TLB flushes:   %C%u\n", TXT_CYAN, tlb_flushes);
+}
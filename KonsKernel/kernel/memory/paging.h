@@ -0,0 +1,61 @@
+// kernel/memory/paging.h
+#ifndef KERNEL_MEMORY_PAGING_H
+#define KERNEL_MEMORY_PAGING_H
+
+#include <stdint.h>
+
+// === Page Directory / Table Eintrag ===
+#define PAGE_PRESENT    0x001
+#define PAGE_WRITE      0x002
+#define PAGE_USER       0x004
+#define PAGE_PWT        0x008       // Write-Through
+#define PAGE_PCD        0x010       // Cache Disable
+#define PAGE_ACCESSED   0x020
+#define PAGE_DIRTY      0x040
+#define PAGE_LARGE      0x080       // PDE: 4 MB Seite (PSE)
+#define PAGE_PAT        0x080       // PTE: PAT-Index Bit 2
+#define PAGE_GLOBAL     0x100
+#define PAGE_LARGE_PAT  0x1000      // PDE (4 MB): PAT-Index Bit 2
+
+#define PAGE_FRAME      0xFFFFF000
+#define LARGE_PAGE_SIZE 0x400000
+#define LARGE_PAGE_FRAME 0xFFC00000
+
+#define PAGING_NO_MAPPING 0xFFFFFFFF
+
+// === PAT Speichertypen ===
+#define PAT_UC          0x00
+#define PAT_WC          0x01
+#define PAT_WT          0x04
+#define PAT_WP          0x05
+#define PAT_WB          0x06
+#define PAT_UC_MINUS    0x07
+
+// Eintrag 1 (PWT=1, PCD=0) wird von WT auf WC umprogrammiert
+#define PAT_VALUE ((uint64_t)PAT_WB | ((uint64_t)PAT_WC << 8) | \
+                   ((uint64_t)PAT_UC_MINUS << 16) | ((uint64_t)PAT_UC << 24) | \
+                   ((uint64_t)PAT_WB << 32) | ((uint64_t)PAT_WT << 40) | \
+                   ((uint64_t)PAT_UC_MINUS << 48) | ((uint64_t)PAT_UC << 56))
+
+// === Cache-Typen für map_mmio ===
+#define MMIO_UNCACHED   0           // Register: jeder Zugriff geht auf den Bus
+#define MMIO_WC         1           // Framebuffer: Write-Combining
+
+// === Funktionen ===
+void paging_init(void);
+int paging_enabled(void);
+int paging_wc_enabled(void);
+
+// Einzelne 4 KB Seite. Wirkt erst nach paging_flush() sicher im TLB!
+int map_page(uint32_t virt, uint32_t phys, uint32_t flags);
+void unmap_page(uint32_t virt);
+void paging_flush(void);
+
+uint32_t virt_to_phys(uint32_t virt);
+
+// Identity-Mapping für Geräte-Speicher, flusht selbst
+void* map_mmio(uint32_t phys, uint32_t size, int type);
+
+void paging_info(void);
+
+#endif
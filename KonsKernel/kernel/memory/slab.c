@@ -0,0 +1,226 @@
+// kernel/memory/slab.c
+#include <stddef.h>
+#include <stdint.h>
+#include "slab.h"
+#include "heap.h"
+#include "../drivers/screen.h"
+#include "../lib/printf.h"
+#include "../lib/utils.h"
+
+// Alle Caches (für slabinfo)
+static kmem_cache_t* cache_list = NULL;
+
+// === Listen-Hilfsfunktionen ===
+static void slab_list_add(slab_t** list, slab_t* slab) {
+    slab->prev = NULL;
+    slab->next = *list;
+    if(*list) (*list)->prev = slab;
+    *list = slab;
+}
+
+static void slab_list_remove(slab_t** list, slab_t* slab) {
+    if(slab->prev) slab->prev->next = slab->next;
+    else *list = slab->next;
+    if(slab->next) slab->next->prev = slab->prev;
+    slab->next = slab->prev = NULL;
+}
+
+// Verkettung freier Objekte. Mit Konstruktor liegt der Zeiger hinter den
+// Objektdaten, damit der konstruierte Zustand alloc/free übersteht.
+static inline void** free_link(kmem_cache_t* cache, void* obj) {
+    return (void**)((uint8_t*)obj + cache->free_offset);
+}
+
+// === Neuen Slab aus einer Bitmap-Seite bauen ===
+static slab_t* slab_grow(kmem_cache_t* cache) {
+    uint8_t* page = (uint8_t*)alloc_page();
+    if(!page) return NULL;
+
+    slab_t* slab = (slab_t*)page;
+    slab->cache = cache;
+    slab->inuse = 0;
+    slab->magic = SLAB_MAGIC;
+    slab->free_list = NULL;
+
+    // Free-List rückwärts aufbauen, damit Objekte aufsteigend vergeben werden
+    for(int i = cache->objs_per_slab - 1; i >= 0; i--) {
+        void* obj = page + cache->first_offset + i * cache->obj_size;
+        if(cache->ctor) cache->ctor(obj);
+        *free_link(cache, obj) = slab->free_list;
+        slab->free_list = obj;
+    }
+
+    cache->slab_count++;
+    return slab;
+}
+
+static void slab_release(kmem_cache_t* cache, slab_t* slab) {
+    slab->magic = 0;
+    cache->slab_count--;
+    free_page(slab);
+}
+
+// === Cache anlegen ===
+kmem_cache_t* kmem_cache_create(const char* name, uint32_t size, uint32_t align,
+                                uint32_t flags, void (*ctor)(void* obj)) {
+    if(size == 0) return NULL;
+
+    if(align < sizeof(void*)) align = sizeof(void*);
+    if(flags & SLAB_HWCACHE_ALIGN) {
+        if(align < CACHE_LINE_SIZE) align = CACHE_LINE_SIZE;
+    }
+    if(align & (align - 1)) return NULL;  // Nur Zweierpotenzen
+
+    // Objekt muss mindestens den Free-List Zeiger aufnehmen - mit Konstruktor
+    // bekommt er eigene Bytes hinter den Daten
+    uint32_t free_offset = 0;
+    if(ctor) {
+        free_offset = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+        size = free_offset + sizeof(void*);
+    }
+    if(size < sizeof(void*)) size = sizeof(void*);
+    uint32_t obj_size = (size + align - 1) & ~(align - 1);
+
+    uint32_t first_offset = (sizeof(slab_t) + align - 1) & ~(align - 1);
+    if(first_offset + obj_size > PAGE_SIZE) {
+        kprintf(0x4F, "SLAB: Object too large for cache %s\n", name);
+        return NULL;
+    }
+
+    kmem_cache_t* cache = (kmem_cache_t*)kmalloc_safe(sizeof(kmem_cache_t));
+    if(!cache) return NULL;
+
+    int i = 0;
+    while(name[i] && i < SLAB_NAME_LEN - 1) {
+        cache->name[i] = name[i];
+        i++;
+    }
+    cache->name[i] = '\0';
+
+    cache->obj_size = obj_size;
+    cache->align = align;
+    cache->first_offset = first_offset;
+    cache->free_offset = free_offset;
+    cache->objs_per_slab = (PAGE_SIZE - first_offset) / obj_size;
+    cache->ctor = ctor;
+    cache->partial = NULL;
+    cache->full = NULL;
+    cache->empty = NULL;
+    cache->slab_count = 0;
+    cache->active_objs = 0;
+
+    cache->next = cache_list;
+    cache_list = cache;
+
+    return cache;
+}
+
+// === Cache entfernen (alle Objekte müssen freigegeben sein) ===
+void kmem_cache_destroy(kmem_cache_t* cache) {
+    if(!cache) return;
+
+    if(cache->active_objs != 0) {
+        kprintf(0x1E, "SLAB: Destroying cache with active objects: %s\n", cache->name);
+        return;
+    }
+
+    kmem_cache_shrink(cache);
+    while(cache->partial) {
+        slab_t* slab = cache->partial;
+        slab_list_remove(&cache->partial, slab);
+        slab_release(cache, slab);
+    }
+
+    kmem_cache_t** link = &cache_list;
+    while(*link && *link != cache) link = &(*link)->next;
+    if(*link) *link = cache->next;
+
+    kfree_safe(cache);
+}
+
+// === Objekt holen ===
+void* kmem_cache_alloc(kmem_cache_t* cache) {
+    slab_t* slab = cache->partial;
+
+    if(!slab) {
+        // Reserve-Slab benutzen oder neue Seite holen
+        slab = cache->empty;
+        if(slab) {
+            cache->empty = NULL;
+        } else {
+            slab = slab_grow(cache);
+            if(!slab) return NULL;
+        }
+        slab_list_add(&cache->partial, slab);
+    }
+
+    // Fast Path: Kopf der Free-List abnehmen
+    void* obj = slab->free_list;
+    slab->free_list = *free_link(cache, obj);
+    slab->inuse++;
+    cache->active_objs++;
+
+    if(!slab->free_list) {
+        slab_list_remove(&cache->partial, slab);
+        slab_list_add(&cache->full, slab);
+    }
+
+    return obj;
+}
+
+// === Objekt zurückgeben ===
+// Ein Objekt mit Konstruktor muss im "konstruierten" Zustand zurückkommen.
+void kmem_cache_free(kmem_cache_t* cache, void* obj) {
+    if(!obj) return;
+
+    slab_t* slab = (slab_t*)((uint32_t)obj & ~(PAGE_SIZE - 1));
+    if(slab->magic != SLAB_MAGIC || slab->cache != cache) {
+        kprintf(0x4F, "SLAB: Free of foreign object 0x%08X\n", (uint32_t)obj);
+        return;
+    }
+
+    int was_full = (slab->free_list == NULL);
+
+    *free_link(cache, obj) = slab->free_list;
+    slab->free_list = obj;
+    slab->inuse--;
+    cache->active_objs--;
+
+    if(was_full) {
+        slab_list_remove(&cache->full, slab);
+        slab_list_add(&cache->partial, slab);
+    }
+
+    if(slab->inuse == 0) {
+        slab_list_remove(&cache->partial, slab);
+        if(cache->empty) {
+            slab_release(cache, slab);  // Nur einen leeren Slab behalten
+        } else {
+            cache->empty = slab;
+        }
+    }
+}
+
+// === Reserve-Slab zurück an die Page-Bitmap ===
+void kmem_cache_shrink(kmem_cache_t* cache) {
+    if(cache->empty) {
+        slab_release(cache, cache->empty);
+        cache->empty = NULL;
+    }
+}
+
+// === slabinfo ===
+void slab_info(void) {
+    kprint("\nCache            ObjSize  Active  Total  Slabs\n", TXT_INFO);
+
+    if(!cache_list) {
+        kprint("No caches.\n", TXT_WARNING);
+        return;
+    }
+
+    for(kmem_cache_t* c = cache_list; c; c = c->next) {
+        kprintf(TXT_NORMAL, "%-17s%C%-9u%C%-8u%C%-7u%u\n", c->name, TXT_CYAN, c->obj_size,
+                TXT_SUCCESS, c->active_objs, TXT_NORMAL, c->slab_count * c->objs_per_slab,
+                c->slab_count);
+    }
+}
@@ -0,0 +1,54 @@
+// kernel/memory/slab.h
+#ifndef KERNEL_MEMORY_SLAB_H
+#define KERNEL_MEMORY_SLAB_H
+
+#include <stdint.h>
+
+// === Slab Konstanten ===
+#define CACHE_LINE_SIZE     64
+#define SLAB_MAGIC          0x51AB51AB
+#define SLAB_NAME_LEN       16
+
+// Flags für kmem_cache_create
+#define SLAB_HWCACHE_ALIGN  0x01   // Objekte auf Cache-Line ausrichten
+
+// === Slab: eine physische Seite, Header am Seitenanfang ===
+typedef struct slab {
+    struct slab* next;
+    struct slab* prev;
+    struct kmem_cache* cache;
+    void* free_list;        // Einfach verkettete Liste freier Objekte
+    uint32_t inuse;         // Belegte Objekte in diesem Slab
+    uint32_t magic;         // SLAB_MAGIC
+} slab_t;
+
+// === Object Cache ===
+typedef struct kmem_cache {
+    char name[SLAB_NAME_LEN];
+    uint32_t obj_size;      // Größe inkl. Padding
+    uint32_t align;
+    uint32_t first_offset;  // Offset des ersten Objekts im Slab
+    uint32_t free_offset;   // Free-List Zeiger im Objekt (mit ctor hinter den Daten)
+    uint32_t objs_per_slab;
+    void (*ctor)(void* obj);
+
+    slab_t* partial;        // Slabs mit freien Objekten (Fast Path)
+    slab_t* full;           // Komplett belegte Slabs
+    slab_t* empty;          // Max. ein leerer Slab als Reserve
+
+    uint32_t slab_count;
+    uint32_t active_objs;
+
+    struct kmem_cache* next;  // Liste aller Caches (slabinfo)
+} kmem_cache_t;
+
+// === Funktionen ===
+kmem_cache_t* kmem_cache_create(const char* name, uint32_t size, uint32_t align,
+                                uint32_t flags, void (*ctor)(void* obj));
+void kmem_cache_destroy(kmem_cache_t* cache);
+void* kmem_cache_alloc(kmem_cache_t* cache);
+void kmem_cache_free(kmem_cache_t* cache, void* obj);
+void kmem_cache_shrink(kmem_cache_t* cache);
+void slab_info(void);
+
+#endif
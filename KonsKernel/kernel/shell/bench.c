@@ -0,0 +1,412 @@
+// kernel/shell/bench.c - Microbenchmarks (bench <name>)
+#include "commands.h"
+#include "../drivers/screen.h"
+#include "../memory/heap.h"
+#include "../lib/string.h"
+#include "../lib/utils.h"
+#include "../lib/printf.h"
+#include "../lib/mem.h"
+#include "../cpu/cpu.h"
+#include "../cpu/fpu.h"
+#include "../memory/paging.h"
+#include "../drivers/ahci.h"
+#include "../drivers/fbcon.h"
+
+#define BENCH_BYTES (1024 * 1024)   // Gesamtmenge pro Messung
+
+static const uint32_t bench_sizes[] = { 16, 64, 256, 1024, 4096, 16384, 65536 };
+#define BENCH_SIZE_COUNT (sizeof(bench_sizes) / sizeof(bench_sizes[0]))
+
+// Nur Subtraktion - 64-Bit Division gibt es ohne libgcc nicht
+static uint32_t cycles_since(uint64_t start) {
+    uint32_t cycles = (uint32_t)(rdtsc() - start);
+    return cycles ? cycles : 1;
+}
+
+// Wert mit zwei Nachkommastellen (value_x100 = Wert * 100) für "%u.%02u"
+#define FIXED2(value_x100) (value_x100) / 100, (value_x100) % 100
+
+// Bytes pro Takt * 100
+static uint32_t rate_x100(uint32_t bytes, uint32_t cycles) {
+    if(cycles > 0xFFFFFFFF / 100) return bytes / (cycles / 100);
+    return (bytes * 100) / cycles;
+}
+
+// Referenz: die alte Byte-Schleife
+static void copy_bytes(uint8_t* dst, const uint8_t* src, uint32_t n) {
+    for(uint32_t i = 0; i < n; i++) {
+        dst[i] = src[i];
+    }
+}
+
+// ========================
+// BENCH MEM
+// ========================
+static void bench_mem(void) {
+    uint32_t max = bench_sizes[BENCH_SIZE_COUNT - 1];
+    uint8_t* src = (uint8_t*)malloc_aligned(max, 64);
+    uint8_t* dst = (uint8_t*)malloc_aligned(max, 64);
+    if(!src || !dst) {
+        kprint("bench: out of memory\n", TXT_ERROR);
+        kfree_safe(src);
+        kfree_safe(dst);
+        return;
+    }
+    memset(src, 0x5A, max);
+    memset(dst, 0, max);
+
+    kprint("\n=== Memory Benchmark (bytes/cycle) ===\n", TXT_INFO);
+    kprintf(TXT_NORMAL, "memcpy path: %C%s\n", TXT_CYAN,
+            mem_sse_enabled() ? "rep movsd + SSE2" : "rep movsd");
+    kprint("    Size   byteloop    memcpy    memset\n", TXT_GRAY);
+
+    for(uint32_t s = 0; s < BENCH_SIZE_COUNT; s++) {
+        uint32_t size = bench_sizes[s];
+        uint32_t rounds = BENCH_BYTES / size;
+        uint64_t start;
+
+        start = rdtsc();
+        for(uint32_t r = 0; r < rounds; r++) copy_bytes(dst, src, size);
+        uint32_t bytes = rate_x100(BENCH_BYTES, cycles_since(start));
+
+        start = rdtsc();
+        for(uint32_t r = 0; r < rounds; r++) memcpy(dst, src, size);
+        uint32_t copy = rate_x100(BENCH_BYTES, cycles_since(start));
+
+        start = rdtsc();
+        for(uint32_t r = 0; r < rounds; r++) memset(dst, r, size);
+        uint32_t set = rate_x100(BENCH_BYTES, cycles_since(start));
+
+        kprintf(TXT_NORMAL, "%8u%C%8u.%02u%C%7u.%02u%7u.%02u\n", size, TXT_GRAY, FIXED2(bytes),
+                TXT_SUCCESS, FIXED2(copy), FIXED2(set));
+    }
+
+    kfree_safe(src);
+    kfree_safe(dst);
+}
+
+// ========================
+// BENCH STR
+// ========================
+
+// Referenz: die alten Byte-Schleifen
+static int ref_strlen(const char* s) {
+    int len = 0;
+    while(s[len]) len++;
+    return len;
+}
+
+static int ref_strcmp(const char* s1, const char* s2) {
+    while(*s1 && (*s1 == *s2)) {
+        s1++;
+        s2++;
+    }
+    return *(const unsigned char*)s1 - *(const unsigned char*)s2;
+}
+
+static char* ref_strstr(const char* haystack, const char* needle) {
+    if(!*needle) return (char*)haystack;
+    for(; *haystack; haystack++) {
+        const char* h = haystack;
+        const char* n = needle;
+        while(*h && *n && *h == *n) {
+            h++;
+            n++;
+        }
+        if(!*n) return (char*)haystack;
+    }
+    return NULL;
+}
+
+static const uint32_t str_sizes[] = { 8, 64, 512, 4096 };
+#define STR_SIZE_COUNT (sizeof(str_sizes) / sizeof(str_sizes[0]))
+#define STR_ROUNDS 64
+
+// Takte pro Aufruf
+static uint32_t time_strlen(int (*fn)(const char*), const char* s) {
+    uint64_t start = rdtsc();
+    for(int r = 0; r < STR_ROUNDS; r++) fn(s);
+    return cycles_since(start) / STR_ROUNDS;
+}
+
+static uint32_t time_strcmp(int (*fn)(const char*, const char*), const char* a, const char* b) {
+    uint64_t start = rdtsc();
+    for(int r = 0; r < STR_ROUNDS; r++) fn(a, b);
+    return cycles_since(start) / STR_ROUNDS;
+}
+
+static void bench_str(void) {
+    uint32_t max = str_sizes[STR_SIZE_COUNT - 1];
+    char* a = (char*)malloc_aligned(max + 1, 64);
+    char* b = (char*)malloc_aligned(max + 1, 64);
+    if(!a || !b) {
+        kprint("bench: out of memory\n", TXT_ERROR);
+        kfree_safe(a);
+        kfree_safe(b);
+        return;
+    }
+
+    kprint("\n=== String Benchmark (cycles/call) ===\n", TXT_INFO);
+    kprintf(TXT_NORMAL, "Dispatch: %C%s\n", TXT_CYAN, string_impl_name());
+    kprint("    Len  strlen:byte    word    sse2  sse4.2  strcmp:byte   strcmp\n", TXT_GRAY);
+
+    for(uint32_t s = 0; s < STR_SIZE_COUNT; s++) {
+        uint32_t len = str_sizes[s];
+        memset(a, 'x', len);
+        memset(b, 'x', len);
+        a[len] = '\0';
+        b[len] = '\0';
+
+        kprintf(TXT_NORMAL, "%7u%C%13u%C%8u", len, TXT_GRAY, time_strlen(ref_strlen, a),
+                TXT_SUCCESS, time_strlen(strlen_word, a));
+        if(cpu.sse2 && fpu_sse_enabled()) kprintf(TXT_SUCCESS, "%8u", time_strlen(strlen_sse2, a));
+        else kprintf(TXT_GRAY, "%8s", "-");
+        if(cpu.sse42 && fpu_sse_enabled()) kprintf(TXT_SUCCESS, "%8u", time_strlen(strlen_sse42, a));
+        else kprintf(TXT_GRAY, "%8s", "-");
+
+        kprintf(TXT_GRAY, "%13u%C%9u\n", time_strcmp(ref_strcmp, a, b), TXT_SUCCESS,
+                time_strcmp(strcmp, a, b));
+    }
+
+    // Schlimmster Fall für die naive Suche: "aaa...a" nach "aa...ab"
+    memset(a, 'a', max);
+    a[max] = '\0';
+    memset(b, 'a', 63);
+    b[63] = 'b';
+    b[64] = '\0';
+
+    uint64_t start = rdtsc();
+    ref_strstr(a, b);
+    uint32_t naive = cycles_since(start);
+
+    start = rdtsc();
+    xstrstr(a, b);
+    uint32_t twoway = cycles_since(start);
+
+    kprintf(TXT_NORMAL, "xstrstr 4096/64 worst case:  byte %C%u%C  two-way %C%u\n",
+            TXT_GRAY, naive, TXT_NORMAL, TXT_SUCCESS, twoway);
+
+    kfree_safe(a);
+    kfree_safe(b);
+}
+
+// ========================
+// BENCH SCREEN
+// ========================
+#define SCREEN_BENCH_LINES 400
+
+static const char screen_line[] =
+    "The quick brown fox jumps over the lazy dog - 0123456789 ABCDEFGHIJKLMNOPQRS";
+
+// Zeilen 1-23 immer wieder überschreiben und jede Zeile sofort flushen,
+// Dauer in TSC-Takten
+static uint64_t screen_pass(void) {
+    screen_flush();
+    uint64_t start = rdtsc();
+    for(int i = 0; i < SCREEN_BENCH_LINES; i++) {
+        kprint_at(screen_line, 0, 1 + (i % (SCREEN_HEIGHT - 2)), TXT_NORMAL);
+        screen_flush();
+    }
+    return rdtsc() - start;
+}
+
+static void print_screen_result(const char* name, uint32_t chars, uint64_t cycles) {
+    uint32_t us = tsc_to_us(cycles, cpu.tsc_khz);
+    if(us == 0) {
+        // Nicht kalibriert: Takte pro Zeichen
+        kprintf(TXT_NORMAL, "%-17s%C%u%C cycles/char\n", name, TXT_SUCCESS,
+                (uint32_t)div64_32(cycles, chars), TXT_NORMAL);
+        return;
+    }
+
+    kprintf(TXT_NORMAL, "%-17s%C%10u%C chars/s  (%C%u%C us)\n", name, TXT_SUCCESS,
+            (uint32_t)div64_32((uint64_t)chars * 1000000, us), TXT_NORMAL, TXT_GRAY, us, TXT_NORMAL);
+}
+
+static void print_screen_stats(void) {
+    uint32_t scrolls, flushes, lines;
+    screen_stats(&scrolls, &flushes, &lines);
+    kprintf(TXT_NORMAL, "shadow buffer:   %C%u%C flushes, %C%u%C lines copied, %C%u%C scrolls\n",
+            TXT_GRAY, flushes, TXT_NORMAL, TXT_GRAY, lines, TXT_NORMAL, TXT_GRAY, scrolls, TXT_NORMAL);
+}
+
+// Mit Framebuffer-Konsole geht screen_flush nicht mehr nach 0xB8000, sondern
+// über Back Buffer und WC-LFB - dann genau diesen Pfad messen
+static void bench_screen_fbcon(uint32_t chars) {
+    clear_screen(THEME_BACKGROUND);
+    uint64_t cycles = screen_pass();
+
+    clear_screen(THEME_BACKGROUND);
+    kprint("\n=== Screen Benchmark ===\n", TXT_INFO);
+    kprint("Framebuffer console active - VGA text buffer comparison skipped\n", TXT_WARNING);
+    print_screen_result("fbcon (WC LFB):", chars, cycles);
+    print_screen_stats();
+}
+
+static void bench_screen(void) {
+    uint32_t chars = SCREEN_BENCH_LINES * strlen(screen_line);
+    if(fbcon_active()) {
+        bench_screen_fbcon(chars);
+        return;
+    }
+
+    // Vorher: Textpuffer uncached wie vor PAT
+    map_mmio(VIDEO_MEMORY, VIDEO_MEMORY_SIZE, MMIO_UNCACHED);
+    clear_screen(THEME_BACKGROUND);
+    uint64_t uc = screen_pass();
+
+    // Nachher: Write-Combining
+    map_mmio(VIDEO_MEMORY, VIDEO_MEMORY_SIZE, MMIO_WC);
+    clear_screen(THEME_BACKGROUND);
+    uint64_t wc = screen_pass();
+
+    clear_screen(THEME_BACKGROUND);
+    kprint("\n=== Screen Benchmark ===\n", TXT_INFO);
+    if(!paging_wc_enabled()) {
+        kprint("No PAT - both runs use an uncached mapping\n", TXT_WARNING);
+    }
+    print_screen_result("uncached:", chars, uc);
+    print_screen_result("write-combining:", chars, wc);
+
+    // Faktor mit zwei Nachkommastellen
+    if(wc) {
+        uint32_t speedup = (uint32_t)div64_32(uc * 100, (uint32_t)(wc > 0xFFFFFFFF ? 0xFFFFFFFF : wc));
+        kprintf(TXT_NORMAL, "speedup:         %C%u.%02ux\n", TXT_CYAN, FIXED2(speedup));
+    }
+
+    print_screen_stats();
+}
+
+// ========================
+// BENCH DISK
+// ========================
+static const uint32_t disk_sizes[] = { 4096, 65536, 262144 };
+#define DISK_SIZE_COUNT (sizeof(disk_sizes) / sizeof(disk_sizes[0]))
+#define DISK_BENCH_BYTES (8 * 1024 * 1024)
+#define DISK_RANDOM_READS 4096          // 4-KB-Lesezugriffe pro Queue-Tiefe
+
+static volatile uint32_t disk_completed;
+static volatile uint32_t disk_failed;
+
+static void disk_read_done(int status, void* ctx) {
+    disk_completed++;
+    if(status) disk_failed++;
+}
+
+// Zufällige 4-KB-Lesezugriffe mit depth Befehlen gleichzeitig (NCQ)
+static void bench_disk_random(struct ahci_drive* drive, uint8_t* buf) {
+    uint32_t blocks = drive->sectors >> 35 ? 0xFFFFFFFF : (uint32_t)(drive->sectors >> 3);
+    uint32_t seed = 0x2545F491;
+    if(!blocks) return;
+
+    kprint("\n=== Disk Benchmark (random 4 KB read) ===\n", TXT_INFO);
+    kprint("   Depth      IOPS      MB/s\n", TXT_GRAY);
+
+    for(int depth = 1; depth <= drive->queue_depth; depth *= 2) {
+        disk_completed = 0;
+        disk_failed = 0;
+
+        uint64_t start = rdtsc();
+        uint32_t submitted;
+        for(submitted = 0; submitted < DISK_RANDOM_READS; submitted++) {
+            if(ahci_wait_queue(drive->port, depth - 1) < 0) break;
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            // Alle Anfragen lesen in denselben Puffer - die Daten interessieren nicht
+            if(ahci_submit(drive->port, (uint64_t)(seed % blocks) << 3, 8, buf, 0,
+                           disk_read_done, 0) < 0) break;
+        }
+        ahci_wait_queue(drive->port, 0);
+        uint32_t us = tsc_to_us(rdtsc() - start, cpu.tsc_khz);
+
+        if(submitted < DISK_RANDOM_READS || disk_failed) {
+            kprintf(TXT_NORMAL, "%8d%C  read error\n", depth, TXT_ERROR);
+            return;
+        }
+        uint32_t iops = us ? (uint32_t)div64_32((uint64_t)disk_completed * 1000000, us) : 0;
+        uint32_t rate = us ? rate_x100(disk_completed * 4096, us) : 0;
+        kprintf(TXT_NORMAL, "%8d%C%10u%C%7u.%02u\n", depth, TXT_SUCCESS, iops, TXT_GRAY, FIXED2(rate));
+    }
+
+    if(!drive->ncq) kprint("Drive has no NCQ - one command at a time\n", TXT_WARNING);
+}
+
+// Nur lesen - der Benchmark darf keine Daten auf der Platte verändern
+static void bench_disk(void) {
+    struct ahci_drive* drive = 0;
+    for(int port = 0; port < AHCI_MAX_PORTS && !drive; port++) drive = ahci_get_drive(port);
+    if(!drive) {
+        kprint("bench: no AHCI drive\n", TXT_ERROR);
+        return;
+    }
+    if(!cpu.tsc_khz) {
+        kprint("bench: TSC not calibrated\n", TXT_ERROR);
+        return;
+    }
+
+    uint32_t max = disk_sizes[DISK_SIZE_COUNT - 1];
+    uint8_t* buf = (uint8_t*)malloc_aligned(max, PAGE_SIZE);
+    if(!buf) {
+        kprint("bench: out of memory\n", TXT_ERROR);
+        return;
+    }
+
+    kprint("\n=== Disk Benchmark (sequential read) ===\n", TXT_INFO);
+    kprint("    Size      MB/s   requests\n", TXT_GRAY);
+
+    for(uint32_t s = 0; s < DISK_SIZE_COUNT; s++) {
+        uint32_t size = disk_sizes[s];
+        uint32_t sectors = size / AHCI_SECTOR_SIZE;
+        uint32_t rounds = DISK_BENCH_BYTES / size;
+        if((uint64_t)rounds * sectors > drive->sectors) rounds = (uint32_t)drive->sectors / sectors;
+
+        uint64_t start = rdtsc();
+        uint32_t r;
+        for(r = 0; r < rounds; r++) {
+            if(ahci_read_sectors(drive->port, (uint64_t)r * sectors, sectors, buf) < 0) break;
+        }
+        uint32_t us = tsc_to_us(rdtsc() - start, cpu.tsc_khz);
+
+        if(r < rounds) {
+            kprintf(TXT_NORMAL, "%8u%C  read error\n", size, TXT_ERROR);
+            break;
+        }
+        // Bytes pro µs = MB/s
+        uint32_t rate = us ? rate_x100(r * size, us) : 0;
+        kprintf(TXT_NORMAL, "%8u%C%7u.%02u%C%11u\n", size, TXT_SUCCESS, FIXED2(rate), TXT_GRAY, r);
+    }
+
+    bench_disk_random(drive, buf);
+    kfree_safe(buf);
+}
+
+// ========================
+// BENCH COMMAND
+// ========================
+void cmd_bench(char* args) {
+    if(!cpu.tsc) {
+        kprint("bench: CPU has no TSC\n", TXT_ERROR);
+        return;
+    }
+
+    if(args && strcmp(args, "mem") == 0) {
+        bench_mem();
+        return;
+    }
+    if(args && strcmp(args, "str") == 0) {
+        bench_str();
+        return;
+    }
+    if(args && strcmp(args, "screen") == 0) {
+        bench_screen();
+        return;
+    }
+
+    if(args && strcmp(args, "disk") == 0) {
+        bench_disk();
+        return;
+    }
+
+    kprint("Usage: bench <mem|str|screen|disk>\n", TXT_YELLOW);
+}
@@ -2,11 +2,26 @@
 #include "commands.h"
 #include "../drivers/screen.h"
 #include "../memory/heap.h"
+#include "../memory/slab.h"
+#include "../memory/buddy.h"
+#include "../memory/paging.h"
 #include "../fs/kfs.h"
 #include "../lib/string.h"
+#include "../lib/printf.h"
+#include "../lib/log.h"
 #include "../drivers/acpi.h"
+#include "../drivers/apic.h"
 #include "../drivers/pci.h"
+#include "../drivers/ahci.h"
+#include "../drivers/serial.h"
+#include "../drivers/fbcon.h"
+#include "../drivers/keyboard.h"
+#include "gui.h"
 #include "../time/time.h"
+#include "../cpu/cpu.h"
+#include "../cpu/fpu.h"
+#include "../cpu/work.h"
+#include "../memory/idt.h"
 
 extern int debug_mode;
 extern struct kfs_inode* inode_table;
@@ -25,17 +40,26 @@ void cmd_help(void) {
     kprint("mem      - Memory information\n", TXT_SUCCESS);
     kprint("mtest    - Test memory allocation\n", TXT_SUCCESS);
     kprint("mdebug   - Memory debug info\n", TXT_SUCCESS);
+    kprint("slabinfo - Slab cache statistics\n", TXT_SUCCESS);
+    kprint("buddyinfo- Free page blocks per order\n", TXT_SUCCESS);
+    kprint("paging   - Page table statistics\n", TXT_SUCCESS);
     kprint("color    - Change text color\n", TXT_SUCCESS);
     kprint("reboot   - Reboot system\n", TXT_WARNING);
     kprint("shutdown - Shutdown system\n", TXT_WARNING);
     kprint("about    - About KonsKernel\n", TXT_SUCCESS);
     kprint("debug    - Toggle debug mode\n", TXT_WARNING);
+    kprint("dmesg    - Kernel log\n", TXT_SUCCESS);
+    kprint("work     - Deferred work statistics\n", TXT_SUCCESS);
+    kprint("irq      - Interrupt statistics\n", TXT_SUCCESS);
+    kprint("disk     - SATA drives (AHCI)\n", TXT_SUCCESS);
+    kprint("gui      - Desktop (framebuffer only, ESC quits)\n", TXT_SUCCESS);
     kprint("ls/dir   - List files\n", TXT_SUCCESS);
     kprint("touch    - Create file\n", TXT_SUCCESS);
     kprint("mkdir    - Create directory\n", TXT_SUCCESS);
     kprint("cat      - Show file\n", TXT_SUCCESS);
     kprint("rm       - Delete file\n", TXT_SUCCESS);
     kprint("fsinfo/df- Filesystem info\n", TXT_SUCCESS);
+    kprint("bench    - Benchmarks (bench mem|str|screen|disk)\n", TXT_SUCCESS);
     kprint("format   - Format filesystem\n", TXT_ERROR);
 }
 
@@ -120,7 +144,12 @@ void cmd_info(void) {
     kprint("Interrupts: Enabled\n", TXT_SUCCESS);
     kprint("Memory:   Full Memory Management\n", TXT_SUCCESS);
     kprint("Heap:     1MB available\n", TXT_NORMAL);
-    kprint("Display:  80x25 VGA Text\n", TXT_NORMAL);
+    fbcon_print_info();
+    cpu_print_info();
+    fpu_print_info();
+    serial_print_info();
+    apic_print_info();
+    kprintf(TXT_NORMAL, "Keyboard: IRQ1 -> scancode ring, %u dropped\n", keyboard_dropped());
 }
 
 // ========================
@@ -133,6 +162,13 @@ void cmd_mem(void) {
 // ========================
 // MEMORY TEST COMMAND
 // ========================
+#define MTEST_PATTERN 0xC0FFEE42
+
+// Konstruktor setzt das erste Wort - genau dort lag früher der Free-List Zeiger
+static void mtest_ctor(void* obj) {
+    *(uint32_t*)obj = MTEST_PATTERN;
+}
+
 void cmd_mtest(void) {
     kprint("\n=== Memory Allocation Test ===\n", TXT_INFO);
 
@@ -151,6 +187,35 @@ void cmd_mtest(void) {
     if(ptr2) kfree_safe(ptr2);
     kprint("[DONE]\n", TXT_SUCCESS);
 
+    kprint("Test 4: Slab cache (64 objects, ctor)... ", TXT_NORMAL);
+    kmem_cache_t* cache = kmem_cache_create("mtest", 48, 0, SLAB_HWCACHE_ALIGN, mtest_ctor);
+    void* objs[64];
+    int count = 0;
+    int ok = (cache != NULL);
+    while(ok && count < 64) {
+        void* obj = kmem_cache_alloc(cache);
+        if(!obj) {
+            ok = 0;
+            break;
+        }
+        objs[count++] = obj;
+        if(((uint32_t)obj & (CACHE_LINE_SIZE - 1)) || *(uint32_t*)obj != MTEST_PATTERN) ok = 0;
+    }
+
+    // Freigeben und neu holen: der konstruierte Zustand muss erhalten bleiben
+    if(ok) {
+        kmem_cache_free(cache, objs[0]);
+        objs[0] = kmem_cache_alloc(cache);
+        if(!objs[0] || *(uint32_t*)objs[0] != MTEST_PATTERN) ok = 0;
+    }
+
+    if(cache) {
+        for(int i = 0; i < count; i++) kmem_cache_free(cache, objs[i]);
+        kmem_cache_destroy(cache);
+    }
+    if(ok) kprint("[OK]\n", TXT_SUCCESS);
+    else kprint("[FAILED]\n", TXT_ERROR);
+
     print_memory_info();
 }
 
@@ -161,6 +226,27 @@ void cmd_mdebug(void) {
     debug_memory();
 }
 
+// ========================
+// SLABINFO COMMAND
+// ========================
+void cmd_slabinfo(void) {
+    slab_info();
+}
+
+// ========================
+// BUDDYINFO COMMAND
+// ========================
+void cmd_buddyinfo(void) {
+    buddy_info();
+}
+
+// ========================
+// PAGING COMMAND
+// ========================
+void cmd_paging(void) {
+    paging_info();
+}
+
 // ========================
 // REBOOT COMMAND
 // ========================
@@ -190,6 +276,43 @@ void cmd_debug(void) {
     }
 }
 
+// ========================
+// DMESG COMMAND
+// ========================
+void cmd_dmesg(void) {
+    kprint("\n", TXT_NORMAL);
+    klog_drain();
+    klog_dump();
+}
+
+// ========================
+// WORK COMMAND
+// ========================
+void cmd_work(void) {
+    work_print_stats();
+}
+
+// ========================
+// IRQ COMMAND
+// ========================
+void cmd_irq(void) {
+    irq_print_stats();
+}
+
+// ========================
+// DISK COMMAND
+// ========================
+void cmd_disk(void) {
+    ahci_print_info();
+}
+
+// ========================
+// GUI COMMAND
+// ========================
+void cmd_gui(void) {
+    gui_run();
+}
+
 // ========================
 // LS COMMAND
 // ========================
@@ -208,23 +331,10 @@ void cmd_ls(void) {
             kprint(inode_table[i].name, TXT_NORMAL);
 
             if(inode_table[i].type == 1) {
-                kprint(" (", TXT_NORMAL);
-                char size_str[16];
-                char* ptr = size_str;
-                uint32_t n = inode_table[i].size;
-                if(n == 0) *ptr++ = '0';
-                else {
-                    char temp[16];
-                    int j = 0;
-                    while(n > 0) { temp[j++] = '0' + (n % 10); n /= 10; }
-                    while(j > 0) *ptr++ = temp[--j];
-                }
-                *ptr++ = 'B';
-                *ptr = '\0';
-                kprint(size_str, TXT_WARNING);
-                kprint(")", TXT_NORMAL);
+                kprintf(TXT_NORMAL, " (%C%uB%C)\n", TXT_WARNING, inode_table[i].size, TXT_NORMAL);
+            } else {
+                kprint("\n", TXT_NORMAL);
             }
-            kprint("\n", TXT_NORMAL);
             count++;
         }
     }
@@ -232,28 +342,7 @@ void cmd_ls(void) {
     if(count == 0) {
         kprint("Directory empty\n", TXT_WARNING);
     } else {
-        kprint("\nTotal: ", TXT_NORMAL);
-        char count_str[16];
-        char* ptr = count_str;
-        int n = count;
-        if(n == 0) *ptr++ = '0';
-        else {
-            char temp[16];
-            int i = 0;
-            while(n > 0) { temp[i++] = '0' + (n % 10); n /= 10; }
-            while(i > 0) *ptr++ = temp[--i];
-        }
-        *ptr++ = ' ';
-        *ptr++ = 'e';
-        *ptr++ = 'n';
-        *ptr++ = 't';
-        *ptr++ = 'r';
-        *ptr++ = 'i';
-        *ptr++ = 'e';
-        *ptr++ = 's';
-        *ptr = '\0';
-        kprint(count_str, TXT_INFO);
-        kprint("\n", TXT_NORMAL);
+        kprintf(TXT_NORMAL, "\nTotal: %C%d entries\n", TXT_INFO, count);
     }
 }
 
@@ -360,42 +449,14 @@ void cmd_rm(char* filename) {
 void cmd_fsinfo(void) {
     kprint("\n=== KFS Information ===\n", TXT_INFO);
 
-    kprint("Volume:     ", TXT_NORMAL);
-    kprint(superblock->volume_name, TXT_INFO);
-    kprint("\n", TXT_NORMAL);
+    kprintf(TXT_NORMAL, "Volume:     %C%s\n", TXT_INFO, superblock->volume_name);
 
     uint32_t total_kb = (superblock->total_blocks * BLOCK_SIZE) / 1024;
     uint32_t free_kb = (superblock->free_blocks * BLOCK_SIZE) / 1024;
-    uint32_t used_kb = total_kb - free_kb;
-
-    kprint("Total:      ", TXT_NORMAL);
-    char num_str[32];
-    char* ptr = num_str;
-    uint32_t n = total_kb;
-    if(n == 0) *ptr++ = '0';
-    else {
-        char temp[32];
-        int i = 0;
-        while(n > 0) { temp[i++] = '0' + (n % 10); n /= 10; }
-        while(i > 0) *ptr++ = temp[--i];
-    }
-    *ptr++ = 'K'; *ptr++ = 'B'; *ptr = '\0';
-    kprint(num_str, TXT_NORMAL);
-    kprint("\n", TXT_NORMAL);
 
-    kprint("Free:       ", TXT_NORMAL);
-    ptr = num_str;
-    n = free_kb;
-    if(n == 0) *ptr++ = '0';
-    else {
-        char temp[32];
-        int i = 0;
-        while(n > 0) { temp[i++] = '0' + (n % 10); n /= 10; }
-        while(i > 0) *ptr++ = temp[--i];
-    }
-    *ptr++ = 'K'; *ptr++ = 'B'; *ptr = '\0';
-    kprint(num_str, free_kb > (total_kb/2) ? TXT_SUCCESS : TXT_WARNING);
-    kprint("\n", TXT_NORMAL);
+    kprintf(TXT_NORMAL, "Total:      %uKB\n", total_kb);
+    kprintf(TXT_NORMAL, "Free:       %C%uKB\n",
+            free_kb > (total_kb/2) ? TXT_SUCCESS : TXT_WARNING, free_kb);
 }
 
 // ========================
@@ -8,13 +8,24 @@ void cmd_clear(void);
 void cmd_echo(char* text);
 void cmd_info(void);
 void cmd_mem(void);
+void cmd_mtest(void);
+void cmd_mdebug(void);
+void cmd_slabinfo(void);
+void cmd_buddyinfo(void);
+void cmd_paging(void);
 void cmd_ls(void);
 void cmd_touch(char* filename);
 void cmd_cat(char* filename);
 void cmd_rm(char* filename);
 void cmd_debug(void);
+void cmd_dmesg(void);
+void cmd_work(void);
+void cmd_irq(void);
+void cmd_disk(void);
+void cmd_gui(void);
 void pci_scan(void);
 void cmd_timezone(char* args);
+void cmd_bench(char* args);
 void unknown_command(char* cmd);
 
 
@@ -28,8 +28,18 @@ void execute_command(char *cmd) {
     else if(strcmp(cmd, "clear") == 0) cmd_clear();
     else if(strcmp(cmd, "info") == 0) cmd_info();
     else if(strcmp(cmd, "mem") == 0 || strcmp(cmd, "memory") == 0) cmd_mem();
+    else if(strcmp(cmd, "mtest") == 0) cmd_mtest();
+    else if(strcmp(cmd, "mdebug") == 0) cmd_mdebug();
+    else if(strcmp(cmd, "slabinfo") == 0) cmd_slabinfo();
+    else if(strcmp(cmd, "buddyinfo") == 0) cmd_buddyinfo();
+    else if(strcmp(cmd, "paging") == 0) cmd_paging();
     else if(strcmp(cmd, "ls") == 0 || strcmp(cmd, "dir") == 0) cmd_ls();
     else if(strcmp(cmd, "debug") == 0) cmd_debug();
+    else if(strcmp(cmd, "dmesg") == 0) cmd_dmesg();
+    else if(strcmp(cmd, "work") == 0) cmd_work();
+    else if(strcmp(cmd, "irq") == 0) cmd_irq();
+    else if(strcmp(cmd, "disk") == 0) cmd_disk();
+    else if(strcmp(cmd, "gui") == 0) cmd_gui();
     else if(strstart(cmd, "echo ")) cmd_echo(cmd + 5);
     else if(strstart(cmd, "touch ")) cmd_touch(cmd + 6);
     else if(strstart(cmd, "cat ")) cmd_cat(cmd + 4);
@@ -40,5 +50,6 @@ void execute_command(char *cmd) {
     else if (strcmp(cmd, "timezone") == 0) {
         cmd_timezone(args);
     }
+    else if (strcmp(cmd, "bench") == 0) cmd_bench(args);
     else unknown_command(cmd);
 }
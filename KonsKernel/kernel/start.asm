@@ -7,8 +7,11 @@ bits 32
 section .multiboot
 align 4
     dd 0x1BADB002              ; Magic
-    dd 0x00000003              ; Flags
-    dd -(0x1BADB002 + 0x00000003) ; Checksum
+    dd 0x00000007              ; Flags (align + memory map + video mode)
+    dd -(0x1BADB002 + 0x00000007) ; Checksum
+    dd 0, 0, 0, 0, 0           ; Adressfelder (nur mit Flag 16)
+    dd 0                       ; Linearer Framebuffer
+    dd 1024, 768, 32           ; Breite, Höhe, Farbtiefe
 
 ; ========================
 ; 2. GLOBAL SYMBOLS
@@ -27,6 +30,9 @@ global _isr24, _isr25, _isr26, _isr27, _isr28, _isr29, _isr30, _isr31
 global _irq0, _irq1, _irq2, _irq3, _irq4, _irq5, _irq6, _irq7
 global _irq8, _irq9, _irq10, _irq11, _irq12, _irq13, _irq14, _irq15
 
+; Einstiegspunkte aller 256 Vektoren für isr_install
+global isr_stub_table
+
 ; ========================
 ; 3. KERNEL START
 ; ========================
@@ -128,8 +134,19 @@ IRQ 13, 45
 IRQ 14, 46
 IRQ 15, 47
 
+; Vektoren 48-255 (APIC, MSI, Software) - push dword, byte wäre ab 128 negativ
+%assign i 16
+%rep 224 - 16
+_irq%+i:
+    push dword 0
+    push dword i + 32
+    jmp irq_common_stub
+%assign i i + 1
+%endrep
+
 ; Common ISR Handler
 isr_common_stub:
+    cld                     ; C-Code erwartet DF=0, iret stellt das alte DF wieder her
     pusha
     push ds
     push es
@@ -157,6 +174,7 @@ isr_common_stub:
 
 ; Common IRQ Handler
 irq_common_stub:
+    cld                     ; C-Code erwartet DF=0, iret stellt das alte DF wieder her
     pusha
     push ds
     push es
@@ -182,6 +200,21 @@ irq_common_stub:
     add esp, 8
     iret
 
+; Stub-Tabelle in Vektor-Reihenfolge
+section .rodata
+align 4
+isr_stub_table:
+%assign i 0
+%rep 32
+    dd _isr%+i
+%assign i i + 1
+%endrep
+%assign i 0
+%rep 224
+    dd _irq%+i
+%assign i i + 1
+%endrep
+
 ; ========================
 ; 5. STACK
 ; ========================